@@ -27,6 +27,16 @@
 
 #define FILE_ADAPTER_READ_PERIOD "ReadPeriod"
 #define FILE_ADAPTER_SAMPLES_PER_READ "SamplesPerRead"
+#define FILE_ADAPTER_READ_MODE "ReadMode"
+#define FILE_ADAPTER_READ_MODE_STREAM "stream"
+#define FILE_ADAPTER_READ_MODE_MMAP "mmap"
+#define FILE_ADAPTER_PACING_MODE "PacingMode"
+#define FILE_ADAPTER_PACING_MODE_PERIOD "period"
+#define FILE_ADAPTER_PACING_MODE_DOWNSTREAM "downstream"
+#define FILE_ADAPTER_PACING_MODE_RATE "rate"
+#define FILE_ADAPTER_RATE_SAMPLES_PER_SECOND "RateSamplesPerSecond"
+#define FILE_ADAPTER_RATE_BYTES_PER_SECOND "RateBytesPerSecond"
+#define FILE_ADAPTER_STATISTICS_PERIOD "StatisticsPeriod"
 #define FILE_ADAPTER_WRITE_MODE "WriteMode"
 #define FILE_ADAPTER_FLUSH "Flush"
 
@@ -38,6 +48,23 @@
 #include "ndds/ndds_c.h"
 #include "routingservice/routingservice_adapter.h"
 
+#include <pthread.h>
+#include <time.h>
+
+/*
+ * How the stream reader thread paces the notifications of data available:
+ * - PERIOD: sleep read_period between batches of samples_per_read
+ * - DOWNSTREAM: notify again as soon as the previous batch has been
+ *   returned by the routing service (bulk loading)
+ * - RATE: like DOWNSTREAM, but limited by a token bucket in samples/s
+ *   or bytes/s (traffic generation)
+ */
+typedef enum {
+    RTI_ROUTING_SERVICE_FILE_PACING_PERIOD,
+    RTI_ROUTING_SERVICE_FILE_PACING_DOWNSTREAM,
+    RTI_ROUTING_SERVICE_FILE_PACING_RATE
+} RTI_RoutingServiceFilePacingMode;
+
 struct RTI_RoutingServiceFileAdapterPlugin {
     struct RTI_RoutingServiceAdapterPlugin _base;
 };
@@ -98,6 +125,53 @@ struct RTI_RoutingServiceFileStreamReader {
     int samples_per_read;
     /*file we are reading */
     FILE *file;
+    /*
+     * when use_mmap is 1 the file is mapped in memory and the samples are
+     * built from payload-sized chunks of the mapping instead of using fread.
+     * mapped_offset is the position of the next chunk to read.
+     */
+    int use_mmap;
+    DDS_Octet *mapped_file;
+    size_t mapped_size;
+    size_t mapped_offset;
+    /* sequence used to loan the chunks of the mapped file */
+    struct DDS_OctetSeq chunk_sequence;
+    /*
+     * chunks of the mapping that could not be set as a sample payload, they
+     * are skipped and only the first one is logged
+     */
+    unsigned long long skipped_chunks;
+    /*
+     * sample list returned by read, together with the samples_per_read
+     * dynamic data samples it points to. They are created once with the
+     * stream reader and reused between read and return_loan.
+     */
+    RTI_RoutingServiceSample *sample_list;
+    /*
+     * pacing state. batch_pending is 1 from the moment we notify data
+     * available until the routing service returns the loan (or reads
+     * nothing), it is protected by pacing_mutex and signaled through
+     * batch_returned. When the rate is in bytes, rate_in_bytes is 1 and
+     * tokens are bytes, otherwise tokens are samples.
+     */
+    RTI_RoutingServiceFilePacingMode pacing_mode;
+    pthread_mutex_t pacing_mutex;
+    pthread_cond_t batch_returned;
+    int batch_pending;
+    double rate;
+    int rate_in_bytes;
+    double tokens;
+    double max_tokens;
+    struct timespec last_refill;
+    /*
+     * statistics about the achieved rate, printed every statistics_period
+     * seconds (if not 0) and when the stream reader is deleted
+     */
+    int statistics_period;
+    unsigned long long samples_read;
+    unsigned long long bytes_read;
+    struct timespec statistics_start;
+    struct timespec last_statistics;
     /*connection which the stream reader belongs to */
     struct RTI_RoutingServiceFileConnection *connection;
     /*the array of filenames present in the source directory*/
@@ -20,6 +20,7 @@
 /*                                                                           */
 /* ========================================================================= */
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -31,7 +32,9 @@
 
 #include <pthread.h>
 #include <semaphore.h>
+#include <sys/mman.h>
 #include <sys/select.h>
+#include <sys/stat.h>
 
 /* This function creates the typecode */
 DDS_TypeCode *RTI_RoutingServiceFileAdapter_create_type_code()
@@ -130,16 +133,208 @@ void RTI_RoutingServiceFileAdapter_delete_type_code(DDS_TypeCode *type_code)
 /*                                                                           */
 /* ========================================================================= */
 
+/*
+ * Returns 1 when there is nothing left to read in the file, either because
+ * we reached the end of the mapping or the end of the FILE stream
+ */
+int RTI_RoutingServiceFileStreamReader_is_eof(
+        struct RTI_RoutingServiceFileStreamReader *self)
+{
+    if (self->use_mmap) {
+        return self->mapped_offset >= self->mapped_size;
+    }
+    return feof(self->file);
+}
+
+/*****************************************************************************/
+
+/* Seconds elapsed between two instants */
+double RTI_RoutingServiceFileAdapter_elapsed_seconds(
+        const struct timespec *from,
+        const struct timespec *to)
+{
+    return (double) (to->tv_sec - from->tv_sec)
+            + (double) (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+/*****************************************************************************/
+
+/*
+ * Returns in deadline the absolute time (in the clock used by
+ * pthread_cond_timedwait) that is seconds away from now
+ */
+void RTI_RoutingServiceFileAdapter_deadline_from_now(
+        struct timespec *deadline,
+        double seconds)
+{
+    long long nanosec = 0;
+
+    clock_gettime(CLOCK_REALTIME, deadline);
+    nanosec = deadline->tv_nsec + (long long) (seconds * 1e9);
+    deadline->tv_sec += (time_t) (nanosec / 1000000000);
+    deadline->tv_nsec = (long) (nanosec % 1000000000);
+}
+
+/*****************************************************************************/
+
+/*
+ * Called when the routing service is done with the last batch we notified,
+ * either because it returned the loan or because read found nothing
+ */
+void RTI_RoutingServiceFileStreamReader_batch_returned(
+        struct RTI_RoutingServiceFileStreamReader *self)
+{
+    pthread_mutex_lock(&self->pacing_mutex);
+    self->batch_pending = 0;
+    pthread_cond_broadcast(&self->batch_returned);
+    pthread_mutex_unlock(&self->pacing_mutex);
+}
+
+/*****************************************************************************/
+
+/*
+ * Waits until the routing service is done with the last batch. In case the
+ * routing service doesn't read it (e.g. the route is paused) we don't wait
+ * more than read_period.
+ */
+void RTI_RoutingServiceFileStreamReader_wait_batch_returned(
+        struct RTI_RoutingServiceFileStreamReader *self)
+{
+    struct timespec deadline;
+
+    RTI_RoutingServiceFileAdapter_deadline_from_now(
+            &deadline,
+            self->read_period.sec + self->read_period.nanosec / 1e9);
+
+    pthread_mutex_lock(&self->pacing_mutex);
+    while (self->batch_pending && self->is_running_enabled) {
+        if (pthread_cond_timedwait(
+                    &self->batch_returned,
+                    &self->pacing_mutex,
+                    &deadline)
+            == ETIMEDOUT) {
+            self->batch_pending = 0;
+        }
+    }
+    pthread_mutex_unlock(&self->pacing_mutex);
+}
+
+/*****************************************************************************/
+
+/*
+ * Token bucket: tokens are refilled at the configured rate up to one batch
+ * worth of tokens, and read takes as many tokens as samples (or bytes) it
+ * produces. A batch can leave the bucket in debt, in that case we wait the
+ * time it takes to pay it back before notifying the next batch.
+ */
+void RTI_RoutingServiceFileStreamReader_wait_tokens(
+        struct RTI_RoutingServiceFileStreamReader *self)
+{
+    struct timespec now;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&self->pacing_mutex);
+    while (self->is_running_enabled) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        self->tokens += self->rate
+                * RTI_RoutingServiceFileAdapter_elapsed_seconds(
+                        &self->last_refill,
+                        &now);
+        if (self->tokens > self->max_tokens) {
+            self->tokens = self->max_tokens;
+        }
+        self->last_refill = now;
+        if (self->tokens >= 0) {
+            break;
+        }
+
+        RTI_RoutingServiceFileAdapter_deadline_from_now(
+                &deadline,
+                -self->tokens / self->rate);
+        pthread_cond_timedwait(
+                &self->batch_returned,
+                &self->pacing_mutex,
+                &deadline);
+    }
+    pthread_mutex_unlock(&self->pacing_mutex);
+}
+
+/*****************************************************************************/
+
+/* Prints the rate achieved since the stream reader was created */
+void RTI_RoutingServiceFileStreamReader_print_statistics(
+        struct RTI_RoutingServiceFileStreamReader *self,
+        const struct timespec *now)
+{
+    double elapsed = 0;
+    unsigned long long samples_read = 0;
+    unsigned long long bytes_read = 0;
+
+    pthread_mutex_lock(&self->pacing_mutex);
+    samples_read = self->samples_read;
+    bytes_read = self->bytes_read;
+    pthread_mutex_unlock(&self->pacing_mutex);
+
+    elapsed = RTI_RoutingServiceFileAdapter_elapsed_seconds(
+            &self->statistics_start,
+            now);
+    if (elapsed <= 0) {
+        return;
+    }
+    fprintf(stdout,
+            "StreamReader %s: %llu samples, %llu bytes in %.3f s "
+            "(%.1f samples/s, %.1f bytes/s)\n",
+            self->info->stream_name,
+            samples_read,
+            bytes_read,
+            elapsed,
+            samples_read / elapsed,
+            bytes_read / elapsed);
+}
+
+/*****************************************************************************/
+
 void *RTI_RoutingServiceFileStreamReader_run(void *threadParam)
 {
     struct RTI_RoutingServiceFileStreamReader *self =
             (struct RTI_RoutingServiceFileStreamReader *) threadParam;
+    struct timespec now;
 
-    /* This thread will notify periodically data availability in the file */
+    /* This thread will notify data availability in the file */
     while (self->is_running_enabled) {
-        NDDS_Utility_sleep(&self->read_period);
+        /*
+         * Once we reach the end of the file we keep checking periodically
+         * in every mode, as there is no batch to wait for.
+         */
+        if (self->pacing_mode == RTI_ROUTING_SERVICE_FILE_PACING_PERIOD
+            || RTI_RoutingServiceFileStreamReader_is_eof(self)) {
+            NDDS_Utility_sleep(&self->read_period);
+        } else {
+            RTI_RoutingServiceFileStreamReader_wait_batch_returned(self);
+            if (self->pacing_mode == RTI_ROUTING_SERVICE_FILE_PACING_RATE) {
+                RTI_RoutingServiceFileStreamReader_wait_tokens(self);
+            }
+        }
+
+        if (self->statistics_period > 0) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (RTI_RoutingServiceFileAdapter_elapsed_seconds(
+                        &self->last_statistics,
+                        &now)
+                >= self->statistics_period) {
+                RTI_RoutingServiceFileStreamReader_print_statistics(
+                        self,
+                        &now);
+                self->last_statistics = now;
+            }
+        }
+
+        if (self->is_running_enabled
+            && !RTI_RoutingServiceFileStreamReader_is_eof(self)) {
+            pthread_mutex_lock(&self->pacing_mutex);
+            self->batch_pending = 1;
+            pthread_mutex_unlock(&self->pacing_mutex);
 
-        if (!feof(self->file)) {
             self->listener.on_data_available(
                     self,
                     self->listener.listener_data);
@@ -188,8 +383,9 @@ void RTI_RoutingServiceFileStreamReader_read(
     int i = 0, sample_counter = 0;
 
     struct DDS_DynamicData *sample = NULL;
-    struct DDS_DynamicDataProperty_t dynamic_data_props =
-            DDS_DynamicDataProperty_t_INITIALIZER;
+    DDS_Long chunk_length = 0;
+    long start_position = 0;
+    long bytes_read = 0;
 
     struct RTI_RoutingServiceFileStreamReader *self =
             (struct RTI_RoutingServiceFileStreamReader *) stream_reader;
@@ -274,63 +470,93 @@ void RTI_RoutingServiceFileStreamReader_read(
     } else {
         fprintf(stdout, "StreamReader: called function read for data\n");
 
-        *sample_list =
-                calloc(self->samples_per_read,
-                       sizeof(RTI_RoutingServiceSample));
-        if (*sample_list == NULL) {
-            RTI_RoutingServiceEnvironment_set_error(
-                    env,
-                    "Failure creating dynamic data "
-                    "sample list in read function");
-            return;
-        }
+        /*
+         * The sample list and its dynamic data samples were created with the
+         * stream reader, we fill the first ones and lend the list to the
+         * routing service until it calls return_loan.
+         */
+        *sample_list = self->sample_list;
+        start_position = self->use_mmap ? (long) self->mapped_offset
+                                        : ftell(self->file);
 
         /*
          *  Read as many times as samples_per_read
          *  (or less if we encounter the end of file)
          */
-        for (i = 0; i < self->samples_per_read && !feof(self->file); i++) {
-            /*
-             * Create a dynamic data sample for every buffer we read. We use
-             * the type we received when the stream reader was created
-             */
-            sample = DDS_DynamicData_new(self->type_code, &dynamic_data_props);
-            if (sample == NULL) {
-                RTI_RoutingServiceEnvironment_set_error(
-                        env,
-                        "Failure creating dynamic data sample in read "
-                        "function");
-                RTI_RoutingServiceFileStreamReader_freeDynamicDataArray(
-                        (struct DDS_DynamicData **) *sample_list,
-                        sample_counter);
-                *sample_list = NULL;
-                return;
-            }
+        for (i = 0; i < self->samples_per_read
+             && !RTI_RoutingServiceFileStreamReader_is_eof(self);
+             i++) {
+            sample = (struct DDS_DynamicData *)
+                    self->sample_list[sample_counter];
             /*
              * Fill the dynamic data sample fields
-             * with the buffer read from the file.
+             * with the buffer read from the file, or with the next chunk
+             * of the mapping.
              */
-            if (!RTI_RoutingServiceFileAdapter_read_sample(
-                        sample,
-                        self->file,
-                        env)) {
+            if (self->use_mmap) {
+                chunk_length = MAX_PAYLOAD_SIZE;
+                if (self->mapped_size - self->mapped_offset
+                    < MAX_PAYLOAD_SIZE) {
+                    chunk_length = (DDS_Long) (self->mapped_size
+                                               - self->mapped_offset);
+                }
+                if (!RTI_RoutingServiceFileAdapter_read_sample_from_buffer(
+                            sample,
+                            &self->chunk_sequence,
+                            self->mapped_file + self->mapped_offset,
+                            chunk_length,
+                            env)) {
+                    /*
+                     * No sample read, skip the chunk so the next read
+                     * doesn't fail on it again
+                     */
+                    if (self->skipped_chunks++ == 0) {
+                        fprintf(stderr,
+                                "ERROR: skipping chunk at offset %lu of "
+                                "stream %s, further failures won't be "
+                                "logged\n",
+                                (unsigned long) self->mapped_offset,
+                                self->info->stream_name);
+                    }
+                    self->mapped_offset += chunk_length;
+                    continue;
+                }
+                self->mapped_offset += chunk_length;
+            } else if (!RTI_RoutingServiceFileAdapter_read_sample(
+                               sample,
+                               self->file,
+                               env)) {
                 /* No sample read */
-                DDS_DynamicData_delete(sample);
                 continue;
             }
 
-            (*sample_list)[sample_counter++] = sample;
+            sample_counter++;
         }
         /* Set the count to the actual number of samples we have generated */
         *count = sample_counter;
+
+        /* Account what we read for the statistics and the token bucket */
+        bytes_read = (self->use_mmap ? (long) self->mapped_offset
+                                     : ftell(self->file))
+                - start_position;
+        pthread_mutex_lock(&self->pacing_mutex);
+        self->samples_read += sample_counter;
+        self->bytes_read += bytes_read;
+        self->tokens -= self->rate_in_bytes ? bytes_read : sample_counter;
+        pthread_mutex_unlock(&self->pacing_mutex);
+        if (sample_counter == 0) {
+            RTI_RoutingServiceFileStreamReader_batch_returned(self);
+        }
     }
     /*
-     * If there are no samples to read we free the memory allocated straight
+     * If there are no samples to read we release the list straight
      * away as the routing service wouldn't call return_loan
      */
     if (*count == 0) {
-        /* If we report zero samples we have to free the array now */
-        free(*sample_list);
+        if (self->connection->input_discovery_reader == self) {
+            /* If we report zero samples we have to free the array now */
+            free(*sample_list);
+        }
         *sample_list = NULL;
     }
 }
@@ -354,7 +580,7 @@ void RTI_RoutingServiceFileStreamReader_return_loan(
 
     /*
      * In case this is called on the discovery data, we free the memory for
-     * sample info otherwise we delete the dynamic data.
+     * sample info otherwise we keep the dynamic data for the next read.
      */
     if (self->connection->input_discovery_reader == self) {
         for (i = 0; i < count; i++) {
@@ -363,9 +589,11 @@ void RTI_RoutingServiceFileStreamReader_return_loan(
         free(sample_list);
         sample_list = NULL;
     } else {
-        RTI_RoutingServiceFileStreamReader_freeDynamicDataArray(
-                (struct DDS_DynamicData **) sample_list,
-                count);
+        /*
+         * Data samples are owned by the stream reader and reused in the
+         * next read, we only let the reader thread know the batch is done.
+         */
+        RTI_RoutingServiceFileStreamReader_batch_returned(self);
     }
 }
 
@@ -483,6 +711,23 @@ void RTI_RoutingServiceFileConnection_delete_session(
 void RTI_RoutingServiceFileStreamReader_delete(
         struct RTI_RoutingServiceFileStreamReader *self)
 {
+    if (self->sample_list != NULL) {
+        RTI_RoutingServiceFileStreamReader_freeDynamicDataArray(
+                (struct DDS_DynamicData **) self->sample_list,
+                self->samples_per_read);
+        self->sample_list = NULL;
+    }
+    if (self->use_mmap) {
+        if (self->mapped_file != NULL) {
+            munmap(self->mapped_file, self->mapped_size);
+            self->mapped_file = NULL;
+        }
+        DDS_OctetSeq_finalize(&self->chunk_sequence);
+    }
+    if (self->connection->input_discovery_reader != self) {
+        pthread_cond_destroy(&self->batch_returned);
+        pthread_mutex_destroy(&self->pacing_mutex);
+    }
     if (self->file != NULL) {
         fclose(self->file);
     }
@@ -504,11 +749,26 @@ RTI_RoutingServiceFileConnection_create_stream_reader(
     struct RTI_RoutingServiceFileStreamReader *stream_reader = NULL;
     int read_period = 0;
     int samples_per_read = 0;
+    int use_mmap = 0;
+    RTI_RoutingServiceFilePacingMode pacing_mode =
+            RTI_ROUTING_SERVICE_FILE_PACING_PERIOD;
+    double rate = 0;
+    int rate_in_bytes = 0;
+    int statistics_period = 0;
     int error = 0;
+    int i = 0;
     const char *read_period_property = NULL;
     const char *samples_per_read_property = NULL;
+    const char *read_mode_property = NULL;
+    const char *pacing_mode_property = NULL;
+    const char *rate_property = NULL;
+    const char *statistics_period_property = NULL;
     char *filename = NULL;
     FILE *file = NULL;
+    struct stat file_stat;
+    struct DDS_DynamicData *sample = NULL;
+    struct DDS_DynamicDataProperty_t dynamic_data_props =
+            DDS_DynamicDataProperty_t_INITIALIZER;
     pthread_attr_t thread_attribute;
     struct RTI_RoutingServiceFileConnection *file_connection =
             (struct RTI_RoutingServiceFileConnection *) connection;
@@ -546,6 +806,87 @@ RTI_RoutingServiceFileConnection_create_stream_reader(
         }
     }
 
+    read_mode_property = RTI_RoutingServiceProperties_lookup_property(
+            properties,
+            FILE_ADAPTER_READ_MODE);
+    if (read_mode_property != NULL) {
+        if (!strcmp(read_mode_property, FILE_ADAPTER_READ_MODE_MMAP)) {
+            use_mmap = 1;
+        } else if (strcmp(read_mode_property, FILE_ADAPTER_READ_MODE_STREAM)) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "Invalid value for %s (%s). "
+                    "Allowed values: stream (default), mmap",
+                    FILE_ADAPTER_READ_MODE,
+                    read_mode_property);
+            return NULL;
+        }
+    }
+
+    pacing_mode_property = RTI_RoutingServiceProperties_lookup_property(
+            properties,
+            FILE_ADAPTER_PACING_MODE);
+    if (pacing_mode_property != NULL) {
+        if (!strcmp(
+                    pacing_mode_property,
+                    FILE_ADAPTER_PACING_MODE_DOWNSTREAM)) {
+            pacing_mode = RTI_ROUTING_SERVICE_FILE_PACING_DOWNSTREAM;
+        } else if (!strcmp(
+                           pacing_mode_property,
+                           FILE_ADAPTER_PACING_MODE_RATE)) {
+            pacing_mode = RTI_ROUTING_SERVICE_FILE_PACING_RATE;
+        } else if (strcmp(
+                           pacing_mode_property,
+                           FILE_ADAPTER_PACING_MODE_PERIOD)) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "Invalid value for %s (%s). "
+                    "Allowed values: period (default), downstream, rate",
+                    FILE_ADAPTER_PACING_MODE,
+                    pacing_mode_property);
+            return NULL;
+        }
+    }
+
+    /* The rate mode needs either a rate in samples/s or in bytes/s */
+    if (pacing_mode == RTI_ROUTING_SERVICE_FILE_PACING_RATE) {
+        rate_property = RTI_RoutingServiceProperties_lookup_property(
+                properties,
+                FILE_ADAPTER_RATE_BYTES_PER_SECOND);
+        if (rate_property != NULL) {
+            rate_in_bytes = 1;
+        } else {
+            rate_property = RTI_RoutingServiceProperties_lookup_property(
+                    properties,
+                    FILE_ADAPTER_RATE_SAMPLES_PER_SECOND);
+        }
+        if (rate_property != NULL) {
+            rate = atof(rate_property);
+        }
+        if (rate <= 0) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "ERROR: PacingMode rate requires a valid %s or %s "
+                    "property",
+                    FILE_ADAPTER_RATE_SAMPLES_PER_SECOND,
+                    FILE_ADAPTER_RATE_BYTES_PER_SECOND);
+            return NULL;
+        }
+    }
+
+    statistics_period_property = RTI_RoutingServiceProperties_lookup_property(
+            properties,
+            FILE_ADAPTER_STATISTICS_PERIOD);
+    if (statistics_period_property != NULL) {
+        statistics_period = atoi(statistics_period_property);
+        if (statistics_period < 0) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "ERROR: statistics_period property value not valid");
+            return NULL;
+        }
+    }
+
     /*
      * now we create the string of the perfect size, the filename is formed by
      * path that we already have by the connection, the / as separator between
@@ -608,6 +949,86 @@ RTI_RoutingServiceFileConnection_create_stream_reader(
             (struct DDS_TypeCode *) stream_info->type_info.type_representation;
     stream_reader->is_running_enabled = 1;
     stream_reader->info = stream_info;
+    stream_reader->use_mmap = use_mmap;
+    stream_reader->pacing_mode = pacing_mode;
+    stream_reader->rate = rate;
+    stream_reader->rate_in_bytes = rate_in_bytes;
+    /* The bucket starts full and holds at most one batch */
+    stream_reader->max_tokens = rate_in_bytes
+            ? (double) samples_per_read * MAX_PAYLOAD_SIZE
+            : (double) samples_per_read;
+    stream_reader->tokens = stream_reader->max_tokens;
+    stream_reader->statistics_period = statistics_period;
+    clock_gettime(CLOCK_MONOTONIC, &stream_reader->statistics_start);
+    stream_reader->last_statistics = stream_reader->statistics_start;
+    stream_reader->last_refill = stream_reader->statistics_start;
+    pthread_mutex_init(&stream_reader->pacing_mutex, NULL);
+    pthread_cond_init(&stream_reader->batch_returned, NULL);
+
+    /*
+     * In mmap mode we map the whole file once. An empty file cannot be
+     * mapped, in that case we simply have nothing to read.
+     */
+    if (use_mmap) {
+        DDS_OctetSeq_initialize(&stream_reader->chunk_sequence);
+        if (fstat(fileno(file), &file_stat) != 0) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "Could not get the size of file %s",
+                    stream_info->stream_name);
+            RTI_RoutingServiceFileStreamReader_delete(stream_reader);
+            return NULL;
+        }
+        stream_reader->mapped_size = (size_t) file_stat.st_size;
+        if (stream_reader->mapped_size > 0) {
+            stream_reader->mapped_file = mmap(
+                    NULL,
+                    stream_reader->mapped_size,
+                    PROT_READ,
+                    MAP_PRIVATE,
+                    fileno(file),
+                    0);
+            if (stream_reader->mapped_file == MAP_FAILED) {
+                stream_reader->mapped_file = NULL;
+                RTI_RoutingServiceEnvironment_set_error(
+                        env,
+                        "Could not map file %s in memory",
+                        stream_info->stream_name);
+                RTI_RoutingServiceFileStreamReader_delete(stream_reader);
+                return NULL;
+            }
+            madvise(stream_reader->mapped_file,
+                    stream_reader->mapped_size,
+                    MADV_SEQUENTIAL);
+        }
+    }
+
+    /*
+     * The sample list and the dynamic data samples are created only once,
+     * read fills them and return_loan gives them back for the next read
+     */
+    stream_reader->sample_list =
+            calloc(samples_per_read, sizeof(RTI_RoutingServiceSample));
+    if (stream_reader->sample_list == NULL) {
+        RTI_RoutingServiceEnvironment_set_error(
+                env,
+                "Failure creating dynamic data sample list");
+        RTI_RoutingServiceFileStreamReader_delete(stream_reader);
+        return NULL;
+    }
+    for (i = 0; i < samples_per_read; i++) {
+        sample = DDS_DynamicData_new(
+                stream_reader->type_code,
+                &dynamic_data_props);
+        if (sample == NULL) {
+            RTI_RoutingServiceEnvironment_set_error(
+                    env,
+                    "Failure creating dynamic data sample");
+            RTI_RoutingServiceFileStreamReader_delete(stream_reader);
+            return NULL;
+        }
+        stream_reader->sample_list[i] = sample;
+    }
 
     pthread_attr_init(&thread_attribute);
     pthread_attr_setdetachstate(&thread_attribute, PTHREAD_CREATE_JOINABLE);
@@ -621,8 +1042,7 @@ RTI_RoutingServiceFileConnection_create_stream_reader(
         RTI_RoutingServiceEnvironment_set_error(
                 env,
                 "Error creating thread for data_available notification");
-        fclose(stream_reader->file);
-        free(stream_reader);
+        RTI_RoutingServiceFileStreamReader_delete(stream_reader);
         return NULL;
     }
 
@@ -638,14 +1058,22 @@ void RTI_RoutingServiceFileConnection_delete_stream_reader(
 {
     struct RTI_RoutingServiceFileStreamReader *self =
             (struct RTI_RoutingServiceFileStreamReader *) stream_reader;
+    struct timespec now;
 
     fprintf(stdout,
             "Connection: called function delete_stream_reader:%s\n",
             self->info->stream_name);
 
+    /* Wake up the thread in case it is waiting for a batch or tokens */
+    pthread_mutex_lock(&self->pacing_mutex);
     self->is_running_enabled = 0;
+    pthread_cond_broadcast(&self->batch_returned);
+    pthread_mutex_unlock(&self->pacing_mutex);
     pthread_join(self->tid, NULL);
 
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    RTI_RoutingServiceFileStreamReader_print_statistics(self, &now);
+
     RTI_RoutingServiceFileStreamReader_delete(self);
 }
 
@@ -60,6 +60,38 @@ int RTI_RoutingServiceFileAdapter_read_sample(
     return 1;
 }
 
+/*
+ * Same as RTI_RoutingServiceFileAdapter_read_sample, but the payload is
+ * taken from a chunk of a memory-mapped file. The chunk is loaned into
+ * chunk_sequence, so no intermediate buffer is allocated or filled for it.
+ */
+int RTI_RoutingServiceFileAdapter_read_sample_from_buffer(
+        struct DDS_DynamicData *sampleOut,
+        struct DDS_OctetSeq *chunk_sequence,
+        DDS_Octet *buffer,
+        DDS_Long length,
+        RTI_RoutingServiceEnvironment *env)
+{
+    DDS_ReturnCode_t retCode = DDS_RETCODE_OK;
+
+    if (!DDS_OctetSeq_loan_contiguous(chunk_sequence, buffer, length, length)) {
+        fprintf(stderr, "ERROR: loaning file chunk\n");
+        return 0;
+    }
+    retCode = DDS_DynamicData_set_octet_seq(
+            sampleOut,
+            "value",
+            DDS_DYNAMIC_DATA_MEMBER_ID_UNSPECIFIED,
+            chunk_sequence);
+    DDS_OctetSeq_unloan(chunk_sequence);
+
+    if (retCode != DDS_RETCODE_OK) {
+        fprintf(stderr, "ERROR: setting sample payload\n");
+        return 0;
+    }
+    return 1;
+}
+
 /* ========================================================================= */
 /*                                                                           */
 /* Write line                                                                */
@@ -35,6 +35,13 @@ int RTI_RoutingServiceFileAdapter_read_sample(
         FILE *file,
         RTI_RoutingServiceEnvironment *env);
 
+int RTI_RoutingServiceFileAdapter_read_sample_from_buffer(
+        struct DDS_DynamicData *sampleOut,
+        struct DDS_OctetSeq *chunk_sequence,
+        DDS_Octet *buffer,
+        DDS_Long length,
+        RTI_RoutingServiceEnvironment *env);
+
 
 /* ========================================================================= */
 /*                                                                           */
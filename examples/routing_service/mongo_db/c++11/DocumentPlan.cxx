@@ -0,0 +1,469 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+
+#include <bsoncxx/types.hpp>
+#include <dds/core/xtypes/CollectionTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+#include <rti/core/Exception.hpp>
+#include <rti/routing/Logger.hpp>
+
+#include "DocumentPlan.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::community::examples;
+
+template<>
+std::vector<uint8_t> &DocumentPlan::ValueBuffers::get<uint8_t>()
+{
+    return uint8_values;
+}
+
+template<>
+std::vector<int16_t> &DocumentPlan::ValueBuffers::get<int16_t>()
+{
+    return int16_values;
+}
+
+template<>
+std::vector<uint16_t> &DocumentPlan::ValueBuffers::get<uint16_t>()
+{
+    return uint16_values;
+}
+
+template<>
+std::vector<int32_t> &DocumentPlan::ValueBuffers::get<int32_t>()
+{
+    return int32_values;
+}
+
+template<>
+std::vector<uint32_t> &DocumentPlan::ValueBuffers::get<uint32_t>()
+{
+    return uint32_values;
+}
+
+template<>
+std::vector<int64_t> &DocumentPlan::ValueBuffers::get<int64_t>()
+{
+    return int64_values;
+}
+
+template<>
+std::vector<float> &DocumentPlan::ValueBuffers::get<float>()
+{
+    return float32_values;
+}
+
+template<>
+std::vector<double> &DocumentPlan::ValueBuffers::get<double>()
+{
+    return float64_values;
+}
+
+DocumentPlan::DocumentPlan(const DynamicType &type, bool binary_collections)
+        : max_depth_(0),
+          binary_collections_(binary_collections),
+          builder_(false)
+{
+    if (type.kind() != TypeKind::STRUCTURE_TYPE) {
+        throw dds::core::InvalidArgumentError(
+                "type " + type.name() + " is not a structure");
+    }
+    compile_members(type, 0);
+}
+
+void DocumentPlan::compile_members(const DynamicType &type, uint32_t depth)
+{
+    const StructType &struct_type = static_cast<const StructType &>(type);
+    for (uint32_t i = 0; i < struct_type.member_count(); ++i) {
+        const Member &member = struct_type.member(i);
+        compile_member(
+                member.type(),
+                i + 1,
+                member.name(),
+                member.is_optional(),
+                depth);
+    }
+}
+
+bool DocumentPlan::compile_member(
+        const DynamicType &type,
+        uint32_t member_index,
+        const std::string &key,
+        bool optional,
+        uint32_t depth)
+{
+    Instruction instruction {
+        Opcode::BOOLEAN, member_index, key, optional, 0, Opcode::BOOLEAN, {}
+    };
+    const DynamicType resolved_type = rti::core::xtypes::resolve_alias(type);
+
+    switch (resolved_type.kind().underlying()) {
+    case TypeKind::BOOLEAN_TYPE:
+        instruction.opcode = Opcode::BOOLEAN;
+        break;
+    case TypeKind::CHAR_8_TYPE:
+        instruction.opcode = Opcode::CHAR_8;
+        break;
+    case TypeKind::UINT_8_TYPE:
+        instruction.opcode = Opcode::UINT_8;
+        break;
+    case TypeKind::INT_16_TYPE:
+        instruction.opcode = Opcode::INT_16;
+        break;
+    case TypeKind::UINT_16_TYPE:
+        instruction.opcode = Opcode::UINT_16;
+        break;
+    case TypeKind::INT_32_TYPE:
+        instruction.opcode = Opcode::INT_32;
+        break;
+    case TypeKind::UINT_32_TYPE:
+        instruction.opcode = Opcode::UINT_32;
+        break;
+    case TypeKind::INT_64_TYPE:
+        instruction.opcode = Opcode::INT_64;
+        break;
+    case TypeKind::ENUMERATION_TYPE:
+        instruction.opcode = Opcode::ENUMERATION;
+        break;
+    case TypeKind::FLOAT_32_TYPE:
+        instruction.opcode = Opcode::FLOAT_32;
+        break;
+    case TypeKind::FLOAT_64_TYPE:
+        instruction.opcode = Opcode::FLOAT_64;
+        break;
+    case TypeKind::STRING_TYPE:
+        instruction.opcode = Opcode::STRING;
+        break;
+
+    case TypeKind::STRUCTURE_TYPE: {
+        uint32_t begin = static_cast<uint32_t>(instructions_.size());
+        instruction.opcode = Opcode::BEGIN_STRUCT;
+        instructions_.push_back(instruction);
+        compile_members(resolved_type, depth + 1);
+        instructions_.push_back(Instruction {
+                Opcode::END_STRUCT, 0, "", false, begin, Opcode::BOOLEAN, {} });
+        instructions_[begin].match =
+                static_cast<uint32_t>(instructions_.size() - 1);
+        max_depth_ = std::max(max_depth_, depth + 1);
+        return true;
+    }
+
+    case TypeKind::SEQUENCE_TYPE:
+    case TypeKind::ARRAY_TYPE: {
+        bool is_array =
+                resolved_type.kind().underlying() == TypeKind::ARRAY_TYPE;
+        uint32_t begin = static_cast<uint32_t>(instructions_.size());
+        instruction.opcode =
+                is_array ? Opcode::BEGIN_ARRAY : Opcode::BEGIN_SEQUENCE;
+        if (is_array) {
+            const ArrayType &array_type =
+                    static_cast<const ArrayType &>(resolved_type);
+            // Elements in each nested BSON array, for the inner dimensions
+            uint32_t stride = 1;
+            for (uint32_t j = array_type.dimension_count() - 1; j > 0; --j) {
+                stride *= array_type.dimension(j);
+                instruction.strides.insert(
+                        instruction.strides.begin(),
+                        stride);
+            }
+        }
+        instructions_.push_back(instruction);
+
+        const DynamicType &content_type = is_array
+                ? static_cast<const ArrayType &>(resolved_type).content_type()
+                : static_cast<const SequenceType &>(resolved_type)
+                          .content_type();
+        if (!compile_member(content_type, 0, "", false, depth + 1)) {
+            // A collection of unsupported elements is left out
+            instructions_.resize(begin);
+            return false;
+        }
+
+        if (instructions_.size() == begin + 2) {
+            switch (instructions_.back().opcode) {
+            case Opcode::UINT_8:
+            case Opcode::INT_16:
+            case Opcode::UINT_16:
+            case Opcode::INT_32:
+            case Opcode::UINT_32:
+            case Opcode::INT_64:
+            case Opcode::FLOAT_32:
+            case Opcode::FLOAT_64:
+                // All the elements are converted by a single instruction
+                instructions_[begin].opcode = Opcode::PRIMITIVE_COLLECTION;
+                instructions_[begin].element_opcode =
+                        instructions_.back().opcode;
+                instructions_.pop_back();
+                return true;
+            default:
+                break;
+            }
+        }
+
+        instructions_.push_back(Instruction {
+                is_array ? Opcode::END_ARRAY : Opcode::END_SEQUENCE,
+                0,
+                "",
+                false,
+                begin,
+                Opcode::BOOLEAN,
+                {} });
+        instructions_[begin].match =
+                static_cast<uint32_t>(instructions_.size() - 1);
+        max_depth_ = std::max(max_depth_, depth + 1);
+        return true;
+    }
+
+    default:
+        rti::routing::Logger::instance().debug(
+                "unsupported type for member=" + key + " ("
+                + resolved_type.name() + ")");
+        return false;
+    }
+
+    instructions_.push_back(instruction);
+    return true;
+}
+
+void DocumentPlan::append_collection(
+        const Instruction &instruction,
+        DynamicData &data,
+        uint32_t index)
+{
+    switch (instruction.element_opcode) {
+    case Opcode::UINT_8:
+        append_values<uint8_t, int32_t>(instruction, data, index);
+        break;
+    case Opcode::INT_16:
+        append_values<int16_t, int32_t>(instruction, data, index);
+        break;
+    case Opcode::UINT_16:
+        append_values<uint16_t, int32_t>(instruction, data, index);
+        break;
+    case Opcode::INT_32:
+        append_values<int32_t, int32_t>(instruction, data, index);
+        break;
+    case Opcode::UINT_32:
+        append_values<uint32_t, int64_t>(instruction, data, index);
+        break;
+    case Opcode::INT_64:
+        append_values<int64_t, int64_t>(instruction, data, index);
+        break;
+    case Opcode::FLOAT_32:
+        append_values<float, double>(instruction, data, index);
+        break;
+    case Opcode::FLOAT_64:
+        append_values<double, double>(instruction, data, index);
+        break;
+    default:
+        throw dds::core::InvalidArgumentError(
+                "invalid element opcode for key=" + instruction.key);
+    }
+}
+
+template<typename Primitive, typename BsonType>
+void DocumentPlan::append_values(
+        const Instruction &instruction,
+        DynamicData &data,
+        uint32_t index)
+{
+    std::vector<Primitive> &values = buffers_.get<Primitive>();
+    data.get_values(index, values);
+
+    if (binary_collections_) {
+        builder_.append(bsoncxx::types::b_binary {
+                bsoncxx::binary_sub_type::k_binary,
+                static_cast<uint32_t>(values.size() * sizeof(Primitive)),
+                reinterpret_cast<const uint8_t *>(values.data()) });
+        return;
+    }
+
+    builder_.open_array();
+    for (uint32_t i = 0; i < values.size(); ++i) {
+        open_nested_arrays(instruction, i);
+        builder_.append(static_cast<BsonType>(values[i]));
+        close_nested_arrays(instruction, i);
+    }
+    builder_.close_array();
+}
+
+void DocumentPlan::open_nested_arrays(
+        const Instruction &instruction,
+        uint32_t element)
+{
+    // From the outermost to the innermost dimension
+    for (uint32_t stride : instruction.strides) {
+        if (element % stride == 0) {
+            builder_.open_array();
+        }
+    }
+}
+
+void DocumentPlan::close_nested_arrays(
+        const Instruction &instruction,
+        uint32_t element)
+{
+    // From the innermost to the outermost dimension
+    for (auto it = instruction.strides.rbegin();
+         it != instruction.strides.rend();
+         ++it) {
+        if ((element + 1) % *it == 0) {
+            builder_.close_array();
+        }
+    }
+}
+
+void DocumentPlan::return_loans()
+{
+    // Loans must be returned from the innermost member
+    while (!loans_.empty()) {
+        loans_.pop_back();
+    }
+    frames_.clear();
+}
+
+bsoncxx::document::value DocumentPlan::to_document(const DynamicData &data)
+{
+    builder_.clear();
+    // The frames and loans never reallocate, so references to them are stable
+    frames_.reserve(max_depth_ + 1);
+    loans_.reserve(max_depth_);
+    frames_.clear();
+    frames_.push_back(Frame { const_cast<DynamicData *>(&data), 0, 0 });
+
+    try {
+        uint32_t pc = 0;
+        while (pc < instructions_.size()) {
+            const Instruction &instruction = instructions_[pc];
+            Frame &frame = frames_.back();
+            DynamicData &current = *frame.data;
+            uint32_t index = instruction.member_index != 0
+                    ? instruction.member_index
+                    : frame.element_index;
+
+            if (instruction.optional && !current.member_exists(index)) {
+                // Skip the member, including its nested instructions
+                pc = (instruction.match != 0 ? instruction.match : pc) + 1;
+                continue;
+            }
+            if (!instruction.key.empty()) {
+                builder_.key_view(instruction.key);
+            }
+
+            switch (instruction.opcode) {
+            case Opcode::BOOLEAN:
+                builder_.append(current.value<DDS_Boolean>(index) != 0);
+                break;
+            case Opcode::CHAR_8:
+                builder_.append(
+                        static_cast<int32_t>(current.value<DDS_Char>(index)));
+                break;
+            case Opcode::UINT_8:
+                builder_.append(
+                        static_cast<int32_t>(current.value<uint8_t>(index)));
+                break;
+            case Opcode::INT_16:
+                builder_.append(
+                        static_cast<int32_t>(current.value<int16_t>(index)));
+                break;
+            case Opcode::UINT_16:
+                builder_.append(
+                        static_cast<int32_t>(current.value<uint16_t>(index)));
+                break;
+            case Opcode::INT_32:
+            case Opcode::ENUMERATION:
+                builder_.append(current.value<int32_t>(index));
+                break;
+            case Opcode::UINT_32:
+                builder_.append(
+                        static_cast<int64_t>(current.value<uint32_t>(index)));
+                break;
+            case Opcode::INT_64:
+                builder_.append(current.value<int64_t>(index));
+                break;
+            case Opcode::FLOAT_32:
+                builder_.append(
+                        static_cast<double>(current.value<float>(index)));
+                break;
+            case Opcode::FLOAT_64:
+                builder_.append(current.value<double>(index));
+                break;
+            case Opcode::STRING:
+                builder_.append(current.value<std::string>(index));
+                break;
+
+            case Opcode::BEGIN_STRUCT:
+                loans_.push_back(current.loan_value(index));
+                frames_.push_back(Frame { &loans_.back().get(), 0, 0 });
+                builder_.open_document();
+                break;
+
+            case Opcode::END_STRUCT:
+                builder_.close_document();
+                frames_.pop_back();
+                loans_.pop_back();
+                break;
+
+            case Opcode::BEGIN_SEQUENCE:
+            case Opcode::BEGIN_ARRAY: {
+                loans_.push_back(current.loan_value(index));
+                DynamicData &collection = loans_.back().get();
+                uint32_t count = collection.member_count();
+                frames_.push_back(Frame { &collection, 1, count });
+                builder_.open_array();
+                if (count == 0) {
+                    // The END instruction closes the empty collection
+                    pc = instruction.match;
+                    continue;
+                }
+                open_nested_arrays(instruction, 0);
+            } break;
+
+            case Opcode::END_SEQUENCE:
+            case Opcode::END_ARRAY: {
+                const Instruction &begin = instructions_[instruction.match];
+                close_nested_arrays(begin, frame.element_index - 1);
+                if (frame.element_index < frame.element_count) {
+                    // Next element
+                    open_nested_arrays(begin, frame.element_index);
+                    ++frame.element_index;
+                    pc = instruction.match + 1;
+                    continue;
+                }
+                builder_.close_array();
+                frames_.pop_back();
+                loans_.pop_back();
+            } break;
+
+            case Opcode::PRIMITIVE_COLLECTION:
+                append_collection(instruction, current, index);
+                break;
+            }
+
+            ++pc;
+        }
+    } catch (...) {
+        return_loans();
+        throw;
+    }
+
+    frames_.clear();
+    return builder_.extract_document();
+}
+
+size_t DocumentPlan::size() const
+{
+    return instructions_.size();
+}
@@ -0,0 +1,200 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef MONGO_DOCUMENTPLAN_HPP
+#define MONGO_DOCUMENTPLAN_HPP
+
+#include <string>
+#include <vector>
+
+#include <bsoncxx/builder/core.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/DynamicType.hpp>
+
+namespace rti { namespace community { namespace examples {
+
+/**
+ * @brief Conversion plan from DynamicData samples of a given type into BSON
+ * documents.
+ *
+ * Converting a sample by reflection requires querying the description of each
+ * member (member_exists(), member_info(), kind dispatch) for every sample,
+ * although it's always the same for a given type. The plan does that work
+ * once: the constructor walks the DynamicType and compiles it into a flat list
+ * of instructions, each one with the member index, kind, BSON key and array
+ * dimensions of a member. to_document() then executes the instructions in a
+ * single loop, with an explicit stack of the complex members being converted,
+ * appending the values to a single BSON builder.
+ *
+ * The mapping is the one described in SampleConverter::to_document().
+ * Members of unsupported types (unions, wide strings and 64-bit unsigned
+ * integers) are left out of the documents.
+ *
+ * Sequences and arrays of numeric primitives are a single instruction: their
+ * elements are obtained at once with get_values() and appended in a single
+ * pass, or stored as a BSON binary when the plan is created with
+ * binary_collections.
+ *
+ * A plan is meant to be created once per stream. to_document() reuses the
+ * state of the plan, so a plan can't be used from multiple threads at the same
+ * time.
+ */
+class DocumentPlan {
+public:
+    /**
+     * @brief Compiles the plan for the specified type, which must be a
+     * structure.
+     *
+     * @param binary_collections
+     *      Whether the sequences and arrays of numeric primitives are stored
+     *      as a BSON binary (generic subtype) with the raw elements, in the
+     *      byte order of the host, instead of a BSON array.
+     */
+    explicit DocumentPlan(
+            const dds::core::xtypes::DynamicType &type,
+            bool binary_collections = false);
+
+    /**
+     * @brief Converts a sample into a BSON document.
+     *
+     * @param data
+     *      Sample of the type the plan was compiled for.
+     */
+    bsoncxx::document::value to_document(
+            const dds::core::xtypes::DynamicData &data);
+
+    /**
+     * @brief Returns the number of instructions of the plan.
+     */
+    size_t size() const;
+
+private:
+    enum class Opcode {
+        BOOLEAN,
+        CHAR_8,
+        UINT_8,
+        INT_16,
+        UINT_16,
+        INT_32,
+        UINT_32,
+        INT_64,
+        ENUMERATION,
+        FLOAT_32,
+        FLOAT_64,
+        STRING,
+        BEGIN_STRUCT,
+        END_STRUCT,
+        BEGIN_SEQUENCE,
+        END_SEQUENCE,
+        BEGIN_ARRAY,
+        END_ARRAY,
+        PRIMITIVE_COLLECTION
+    };
+
+    /**
+     * @brief Each member of a structure is an instruction, or a BEGIN/END pair
+     * enclosing the instructions of its members or elements. The elements of
+     * a collection are described by a single instruction (or BEGIN/END pair)
+     * that is executed once per element.
+     */
+    struct Instruction {
+        Opcode opcode;
+        // Index of the member in its structure. 0 in the element of a
+        // collection, which uses the index of the element being converted.
+        uint32_t member_index;
+        // Key of the member, empty for the elements of a collection
+        std::string key;
+        bool optional;
+        // For BEGIN and END instructions, position of the matching one
+        uint32_t match;
+        // For PRIMITIVE_COLLECTION, opcode of the elements
+        Opcode element_opcode;
+        /**
+         * For multi-dimensional arrays, number of elements in each nested
+         * BSON array, from the outermost to the innermost. DynamicData stores
+         * the elements of all the dimensions in a single flat array.
+         */
+        std::vector<uint32_t> strides;
+    };
+
+    /**
+     * @brief Complex member being converted: the top-level sample, a nested
+     * structure or a collection.
+     */
+    struct Frame {
+        dds::core::xtypes::DynamicData *data;
+        // For collections, current element (1-based) and element count
+        uint32_t element_index;
+        uint32_t element_count;
+    };
+
+    void compile_members(
+            const dds::core::xtypes::DynamicType &type,
+            uint32_t depth);
+
+    bool compile_member(
+            const dds::core::xtypes::DynamicType &type,
+            uint32_t member_index,
+            const std::string &key,
+            bool optional,
+            uint32_t depth);
+
+    /**
+     * @brief Buffers for the elements of the primitive collections, reused
+     * between conversions.
+     */
+    struct ValueBuffers {
+        std::vector<uint8_t> uint8_values;
+        std::vector<int16_t> int16_values;
+        std::vector<uint16_t> uint16_values;
+        std::vector<int32_t> int32_values;
+        std::vector<uint32_t> uint32_values;
+        std::vector<int64_t> int64_values;
+        std::vector<float> float32_values;
+        std::vector<double> float64_values;
+
+        template<typename Primitive>
+        std::vector<Primitive> &get();
+    };
+
+    void append_collection(
+            const Instruction &instruction,
+            dds::core::xtypes::DynamicData &data,
+            uint32_t index);
+
+    template<typename Primitive, typename BsonType>
+    void append_values(
+            const Instruction &instruction,
+            dds::core::xtypes::DynamicData &data,
+            uint32_t index);
+
+    void open_nested_arrays(const Instruction &instruction, uint32_t element);
+
+    void close_nested_arrays(const Instruction &instruction, uint32_t element);
+
+    void return_loans();
+
+    std::vector<Instruction> instructions_;
+    uint32_t max_depth_;
+    bool binary_collections_;
+
+    // Execution state, reused between conversions
+    bsoncxx::builder::core builder_;
+    std::vector<Frame> frames_;
+    std::vector<rti::core::xtypes::LoanedDynamicData> loans_;
+    ValueBuffers buffers_;
+};
+
+}}}  // namespace rti::community::examples
+
+#endif  // MONGO_DOCUMENTPLAN_HPP
@@ -10,6 +10,7 @@
  * use or inability to use the software.
  */
 #include <mongocxx/uri.hpp>
+#include <mongocxx/write_concern.hpp>
 
 #include "MongoConfig.hpp"
 
@@ -112,3 +113,342 @@ std::string MongoConfig::parse<MongoConfig::DB_NAME>(
 
     return it->second;
 }
+
+/*
+ *  --- URI
+ * ---------------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::URI>()
+{
+    static std::string __name("mongo.uri");
+    return __name;
+}
+
+template<>
+std::string MongoConfig::parse<MongoConfig::URI>(
+        const rti::routing::PropertySet &properties)
+{
+    rti::routing::PropertySet::const_iterator it =
+            properties.find(MongoConfig::name<MongoConfig::URI>());
+    if (it != properties.end()) {
+        return it->second;
+    }
+
+    return "";
+}
+
+static int32_t parse_positive_int(
+        const rti::routing::PropertySet &properties,
+        const std::string &name,
+        int32_t default_value,
+        int32_t min_value)
+{
+    rti::routing::PropertySet::const_iterator it = properties.find(name);
+    if (it == properties.end()) {
+        return default_value;
+    }
+
+    int32_t value = 0;
+    try {
+        value = std::stoi(it->second);
+    } catch (const std::exception &) {
+        value = min_value - 1;
+    }
+    if (value < min_value) {
+        throw dds::core::InvalidArgumentError(
+                "invalid value for property " + name + ": " + it->second);
+    }
+
+    return value;
+}
+
+static bool parse_bool(
+        const rti::routing::PropertySet &properties,
+        const std::string &name,
+        bool default_value)
+{
+    rti::routing::PropertySet::const_iterator it = properties.find(name);
+    if (it == properties.end()) {
+        return default_value;
+    }
+
+    if (it->second == "true" || it->second == "1") {
+        return true;
+    }
+    if (it->second == "false" || it->second == "0") {
+        return false;
+    }
+    throw dds::core::InvalidArgumentError(
+            "invalid value for property " + name + ": " + it->second);
+}
+
+/*
+ *  --- Write batch size
+ * -----------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_BATCH_SIZE>()
+{
+    static std::string __name("mongo.write.batch_size");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_BATCH_SIZE, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_BATCH_SIZE>(),
+            1000,
+            1);
+}
+
+/*
+ *  --- Write linger
+ * ---------------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_LINGER_MS>()
+{
+    static std::string __name("mongo.write.linger_ms");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_LINGER_MS, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_LINGER_MS>(),
+            0,
+            0);
+}
+
+/*
+ *  --- Write concern
+ * -------------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_CONCERN>()
+{
+    static std::string __name("mongo.write.write_concern");
+    return __name;
+}
+
+template<>
+mongocxx::write_concern
+        MongoConfig::parse<MongoConfig::WRITE_CONCERN, mongocxx::write_concern>(
+                const rti::routing::PropertySet &properties)
+{
+    mongocxx::write_concern write_concern {};
+    rti::routing::PropertySet::const_iterator it =
+            properties.find(MongoConfig::name<MongoConfig::WRITE_CONCERN>());
+    if (it == properties.end()) {
+        return write_concern;
+    }
+
+    if (it->second == "majority") {
+        write_concern.acknowledge_level(
+                mongocxx::write_concern::level::k_majority);
+        return write_concern;
+    }
+
+    int32_t nodes = parse_positive_int(properties, it->first, 0, 0);
+    if (nodes == 0) {
+        write_concern.acknowledge_level(
+                mongocxx::write_concern::level::k_unacknowledged);
+    } else {
+        write_concern.nodes(nodes);
+    }
+
+    return write_concern;
+}
+
+/*
+ *  --- Write binary collections
+ * --------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_BINARY_COLLECTIONS>()
+{
+    static std::string __name("mongo.write.binary_collections");
+    return __name;
+}
+
+template<>
+bool MongoConfig::parse<MongoConfig::WRITE_BINARY_COLLECTIONS, bool>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_bool(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_BINARY_COLLECTIONS>(),
+            false);
+}
+
+/*
+ *  --- Write time series
+ * ---------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_TIME_SERIES>()
+{
+    static std::string __name("mongo.write.time_series");
+    return __name;
+}
+
+template<>
+bool MongoConfig::parse<MongoConfig::WRITE_TIME_SERIES, bool>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_bool(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_TIME_SERIES>(),
+            false);
+}
+
+/*
+ *  --- Write expire after
+ * --------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_EXPIRE_AFTER_S>()
+{
+    static std::string __name("mongo.write.expire_after_seconds");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_EXPIRE_AFTER_S, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_EXPIRE_AFTER_S>(),
+            0,
+            0);
+}
+
+/*
+ *  --- Write workers
+ * ---------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_WORKERS>()
+{
+    static std::string __name("mongo.write.workers");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_WORKERS, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_WORKERS>(),
+            0,
+            0);
+}
+
+/*
+ *  --- Write queue size
+ * ------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_QUEUE_SIZE>()
+{
+    static std::string __name("mongo.write.queue_size");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_QUEUE_SIZE, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_QUEUE_SIZE>(),
+            10000,
+            1);
+}
+
+/*
+ *  --- Write metrics period
+ * --------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_METRICS_PERIOD_MS>()
+{
+    static std::string __name("mongo.write.metrics_period_ms");
+    return __name;
+}
+
+template<>
+int32_t MongoConfig::parse<MongoConfig::WRITE_METRICS_PERIOD_MS, int32_t>(
+        const rti::routing::PropertySet &properties)
+{
+    return parse_positive_int(
+            properties,
+            MongoConfig::name<MongoConfig::WRITE_METRICS_PERIOD_MS>(),
+            0,
+            0);
+}
+
+/*
+ *  --- Write mode
+ * ---------------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::WRITE_MODE>()
+{
+    static std::string __name("mongo.write.mode");
+    return __name;
+}
+
+template<>
+std::string MongoConfig::parse<MongoConfig::WRITE_MODE>(
+        const rti::routing::PropertySet &properties)
+{
+    const std::string &name = MongoConfig::name<MongoConfig::WRITE_MODE>();
+    rti::routing::PropertySet::const_iterator it = properties.find(name);
+    if (it == properties.end()) {
+        return "insert";
+    }
+
+    if (it->second != "insert" && it->second != "upsert") {
+        throw dds::core::InvalidArgumentError(
+                "invalid value for property " + name + ": " + it->second);
+    }
+    return it->second;
+}
+
+/*
+ *  --- Read mode
+ * ----------------------------------------------------------------------
+ */
+template<>
+const std::string &MongoConfig::name<MongoConfig::READ_MODE>()
+{
+    static std::string __name("mongo.read.mode");
+    return __name;
+}
+
+template<>
+std::string MongoConfig::parse<MongoConfig::READ_MODE>(
+        const rti::routing::PropertySet &properties)
+{
+    const std::string &name = MongoConfig::name<MongoConfig::READ_MODE>();
+    rti::routing::PropertySet::const_iterator it = properties.find(name);
+    if (it == properties.end()) {
+        return "poll";
+    }
+
+    if (it->second != "poll" && it->second != "change_stream") {
+        throw dds::core::InvalidArgumentError(
+                "invalid value for property " + name + ": " + it->second);
+    }
+    return it->second;
+}
@@ -47,7 +47,95 @@ public:
          * @brief Additional DB connection options in MongoDB URI parameters
          * format. Optional. Default: retryWrites=true&w=majority
          */
-        URI_PARAMS
+        URI_PARAMS,
+        /**
+         * @brief Complete MongoDB connection URI, e.g.
+         * mongodb://localhost:27017. When present, CLUSTER_ADDRESS,
+         * USER_AND_PASS and URI_PARAMS are ignored, which allows connecting to
+         * a local mongod instead of a cluster.
+         * Optional. Default: empty
+         */
+        URI,
+        /**
+         * @brief Maximum number of documents inserted with a single
+         * insert_many by a StreamWriter.
+         * Optional. Default: 1000
+         */
+        WRITE_BATCH_SIZE,
+        /**
+         * @brief Maximum time in milliseconds a StreamWriter holds documents
+         * waiting to complete a batch of WRITE_BATCH_SIZE. With 0, the
+         * documents of each write() are inserted before it returns.
+         * Optional. Default: 0
+         */
+        WRITE_LINGER_MS,
+        /**
+         * @brief Write concern of the StreamWriter insertions: "majority", or
+         * the number of nodes that have to acknowledge the insertion (0 for
+         * unacknowledged writes).
+         * Optional. Default: the write concern of the connection URI
+         */
+        WRITE_CONCERN,
+        /**
+         * @brief Whether a StreamWriter stores the sequences and arrays of
+         * numeric primitives as BSON binary (raw elements, in the byte order
+         * of the host) instead of BSON arrays.
+         * Optional. Default: false
+         */
+        WRITE_BINARY_COLLECTIONS,
+        /**
+         * @brief Whether a StreamWriter creates its collection as a MongoDB
+         * time-series collection, whose time field is a top-level timestamp
+         * element with the reception timestamp of the sample. It has no effect
+         * if the collection already exists.
+         * Optional. Default: false
+         */
+        WRITE_TIME_SERIES,
+        /**
+         * @brief Seconds after which the documents are removed, according to
+         * their reception timestamp, either with a TTL index or with the
+         * expiration of the time-series collection. With 0, documents never
+         * expire.
+         * Optional. Default: 0
+         */
+        WRITE_EXPIRE_AFTER_S,
+        /**
+         * @brief Number of threads that insert the documents of a
+         * StreamWriter, each with its own client of the connection pool. With
+         * workers, write() queues the documents instead of inserting them.
+         * With 0, the documents are inserted by the thread that writes or
+         * lingers them.
+         * Optional. Default: 0
+         */
+        WRITE_WORKERS,
+        /**
+         * @brief Maximum number of documents queued for the write workers.
+         * write() blocks while the queue is full.
+         * Optional. Default: 10000
+         */
+        WRITE_QUEUE_SIZE,
+        /**
+         * @brief Period in milliseconds at which a StreamWriter logs the
+         * metrics of its insertions. With 0, they are only logged when the
+         * StreamWriter is deleted.
+         * Optional. Default: 0
+         */
+        WRITE_METRICS_PERIOD_MS,
+        /**
+         * @brief How a StreamWriter stores the samples: "insert" adds a
+         * document per sample, "upsert" keeps a single document per instance,
+         * whose _id holds the key members, and deletes it when the instance
+         * is disposed.
+         * Optional. Default: insert
+         */
+        WRITE_MODE,
+        /**
+         * @brief How a StreamReader obtains the new documents: "poll" reads
+         * them with a query on each take(), "change_stream" watches the
+         * collection and notifies the arrival of documents.
+         * Optional. Default: poll
+         */
+        READ_MODE
     };
 
     template <MongoConfig::property Prop, typename Type = std::string>
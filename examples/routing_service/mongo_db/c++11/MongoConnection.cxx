@@ -25,6 +25,11 @@ using namespace rti::routing::adapter;
 
 std::string build_uri(const PropertySet &properties)
 {
+    std::string uri = MongoConfig::parse<MongoConfig::URI>(properties);
+    if (!uri.empty()) {
+        return uri;
+    }
+
     std::string cluster_addr =
             MongoConfig::parse<MongoConfig::CLUSTER_ADDRESS>(properties);
     std::string user_and_pass =
@@ -74,9 +79,9 @@ rti::routing::adapter::StreamReader *MongoConnection::create_stream_reader(
         rti::routing::adapter::Session *,
         const StreamInfo &stream_info,
         const PropertySet &properties,
-        rti::routing::adapter::StreamReaderListener *)
+        rti::routing::adapter::StreamReaderListener *listener)
 {
-    return new MongoStreamReader(*this, stream_info, properties);
+    return new MongoStreamReader(*this, stream_info, properties, listener);
 }
 
 void MongoConnection::delete_stream_reader(
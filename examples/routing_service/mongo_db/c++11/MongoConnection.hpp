@@ -47,6 +47,7 @@ class MongoStreamWriter;
  *  - MongoConfig::DB_NAME
  *  - MongoConfig::USER_AND_PASS
  *  - MongoConfig::URI_PARAMS
+ *  - MongoConfig::URI
  *
  *  @see MongoConfig
  */
@@ -10,10 +10,15 @@
  * use or inability to use the software.
  */
 
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <bsoncxx/json.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <rti/routing/Logger.hpp>
 
 #include "MongoStreamReader.hpp"
 #include "SampleConverter.hpp"
@@ -22,6 +27,32 @@ using namespace rti::routing;
 using namespace rti::routing::adapter;
 using namespace rti::community::examples;
 using namespace bsoncxx;
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+/*
+ * Maximum number of documents the change stream thread queues. When reached,
+ * the thread stops reading the change stream until they are taken.
+ */
+static const size_t MAX_PENDING_DOCUMENTS = 10000;
+
+/*
+ * Returns the _id of a document as the bytes of its BSON value, so _ids of
+ * any type can be compared, e.g. the ones built from the key members in
+ * upsert mode. Empty if the document has no _id.
+ */
+static std::string raw_id(document::view document)
+{
+    document::element id = document["_id"];
+    if (!id) {
+        return std::string();
+    }
+    document::value id_document = make_document(kvp("", id.get_value()));
+    return std::string(
+            reinterpret_cast<const char *>(id_document.view().data()),
+            id_document.view().length());
+}
 
 document::value MongoStreamReader::find_filter()
 {
@@ -51,12 +82,290 @@ mongocxx::options::find MongoStreamReader::find_options()
 MongoStreamReader::MongoStreamReader(
         MongoConnection &connection,
         const rti::routing::StreamInfo &stream_info,
-        const rti::routing::PropertySet &properties)
+        const rti::routing::PropertySet &properties,
+        StreamReaderListener *listener)
         : connection_(connection),
           stream_name_(stream_info.stream_name()),
           last_read_(std::chrono::system_clock::now()),
-          type_(stream_info.type_info().dynamic_type())
+          type_(stream_info.type_info().dynamic_type()),
+          listener_(listener),
+          change_stream_mode_(
+                  MongoConfig::parse<MongoConfig::READ_MODE>(properties)
+                  == "change_stream"),
+          stop_change_stream_thread_(false)
 {
+    if (change_stream_mode_) {
+        change_stream_thread_ =
+                std::thread(&MongoStreamReader::change_stream_thread, this);
+    }
+}
+
+MongoStreamReader::~MongoStreamReader()
+{
+    if (change_stream_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            stop_change_stream_thread_ = true;
+        }
+        pending_condition_.notify_all();
+        change_stream_thread_.join();
+    }
+}
+
+/*
+ * --- Change stream mode
+ * -----------------------------------------------------------
+ */
+
+mongocxx::change_stream MongoStreamReader::watch(
+        mongocxx::collection &collection,
+        bool &resuming)
+{
+    /*
+     * Only insertions and, for collections written in upsert mode,
+     * replacements. Both events carry the complete document.
+     */
+    mongocxx::pipeline pipeline {};
+    pipeline.match(make_document(kvp(
+            "operationType",
+            make_document(kvp("$in", make_array("insert", "replace"))))));
+
+    /*
+     * Bounds the time the thread blocks waiting for changes, so it notices
+     * when the StreamReader is deleted.
+     */
+    mongocxx::options::change_stream options {};
+    options.max_await_time(std::chrono::milliseconds(500));
+
+    resuming = bool(resume_token_);
+    if (resuming) {
+        /*
+         * An expired or invalid resume token is only reported when the
+         * change stream is iterated, see change_stream_thread().
+         */
+        mongocxx::options::change_stream resume_options = options;
+        resume_options.resume_after(resume_token_->view());
+        return collection.watch(pipeline, resume_options);
+    }
+
+    /*
+     * The change stream is opened before the catch-up query, so documents
+     * inserted in between are reported by both. The change stream skips the
+     * ones the query already reported.
+     */
+    mongocxx::change_stream change_stream =
+            collection.watch(pipeline, options);
+    catch_up(collection);
+    return change_stream;
+}
+
+void MongoStreamReader::catch_up(mongocxx::collection &collection)
+{
+    /*
+     * The range on a single field sorted by the same field can be served by
+     * an index on info.reception_timestamp, without scanning the collection.
+     * Timestamps have millisecond resolution, so the range includes the last
+     * one reported, and the documents already reported with it are skipped.
+     */
+    mongocxx::options::find options {};
+    options.sort(make_document(kvp("info.reception_timestamp", 1)));
+
+    caught_up_ids_.clear();
+    mongocxx::cursor cursor = collection.find(
+            make_document(kvp(
+                    "info.reception_timestamp",
+                    make_document(kvp("$gte", last_read_)))),
+            options);
+    for (const document::view &document : cursor) {
+        std::string id = raw_id(document);
+        if (!id.empty()) {
+            caught_up_ids_.insert(id);
+        }
+        document::element reception_timestamp =
+                document["info"] ? document["info"]["reception_timestamp"]
+                                 : document::element {};
+        if (reception_timestamp && reception_timestamp.type() == type::k_date
+            && reception_timestamp.get_date().value == last_read_.value
+            && !id.empty() && last_read_ids_.count(id) > 0) {
+            continue;
+        }
+        if (!push_document(document)) {
+            return;
+        }
+    }
+}
+
+bool MongoStreamReader::push_document(document::view document)
+{
+    document::element reception_timestamp =
+            document["info"] ? document["info"]["reception_timestamp"]
+                             : document::element {};
+    if (reception_timestamp && reception_timestamp.type() == type::k_date
+        && reception_timestamp.get_date().value >= last_read_.value) {
+        if (reception_timestamp.get_date().value > last_read_.value) {
+            last_read_ = reception_timestamp.get_date();
+            last_read_ids_.clear();
+        }
+        std::string id = raw_id(document);
+        if (!id.empty()) {
+            last_read_ids_.insert(id);
+        }
+    }
+
+    bool notify = false;
+    {
+        std::unique_lock<std::mutex> lock(pending_mutex_);
+        pending_condition_.wait(lock, [this]() {
+            return stop_change_stream_thread_
+                    || pending_documents_.size() < MAX_PENDING_DOCUMENTS;
+        });
+        if (stop_change_stream_thread_) {
+            return false;
+        }
+        // Routing Service takes all the pending documents when notified
+        notify = pending_documents_.empty();
+        pending_documents_.push_back(document::value(document));
+    }
+
+    if (notify && listener_ != nullptr) {
+        listener_->on_data_available(this);
+    }
+    return true;
+}
+
+void MongoStreamReader::change_stream_thread()
+{
+    while (!stop_change_stream_thread_) {
+        bool resuming = false;
+        try {
+            auto client = connection_.client();
+            mongocxx::collection collection =
+                    client->database(connection_.db_name())
+                            .collection(stream_name_);
+            mongocxx::change_stream change_stream =
+                    watch(collection, resuming);
+
+            while (!stop_change_stream_thread_) {
+                // Ends when there are no changes within max_await_time
+                for (const document::view &event : change_stream) {
+                    resume_token_ = document::value(
+                            event["_id"].get_document().view());
+                    document::view document =
+                            event["fullDocument"].get_document().view();
+                    if (!caught_up_ids_.empty()
+                        && caught_up_ids_.erase(raw_id(document))) {
+                        continue;
+                    }
+                    if (!push_document(document)) {
+                        return;
+                    }
+                }
+                // The server accepted the resume token
+                resuming = false;
+                // Advances even if there are no changes
+                if (change_stream.get_resume_token()) {
+                    resume_token_ = document::value(
+                            *change_stream.get_resume_token());
+                }
+            }
+        } catch (const std::exception &ex) {
+            rti::routing::Logger::instance().error(
+                    "change stream failed for stream=" + stream_name_ + ": "
+                    + ex.what());
+            if (resuming) {
+                /*
+                 * e.g. ChangeStreamHistoryLost: the oplog no longer has the
+                 * resume token. The next attempt opens a new change stream
+                 * and catches up with a query instead.
+                 */
+                resume_token_ = {};
+            }
+            // Retry later, resuming from the last change received, if any
+            std::unique_lock<std::mutex> lock(pending_mutex_);
+            pending_condition_.wait_for(
+                    lock,
+                    std::chrono::seconds(1),
+                    [this]() { return bool(stop_change_stream_thread_); });
+        }
+    }
+}
+
+void MongoStreamReader::take_pending_documents(
+        std::vector<dds::core::xtypes::DynamicData *> &samples,
+        std::vector<dds::sub::SampleInfo *> &infos)
+{
+    std::deque<document::value> documents;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        documents.swap(pending_documents_);
+    }
+    // The change stream thread may be waiting for room in the queue
+    pending_condition_.notify_all();
+
+    for (const document::value &document : documents) {
+        take_document(document.view(), samples, infos);
+    }
+}
+
+void MongoStreamReader::take_document(
+        document::view document,
+        std::vector<dds::core::xtypes::DynamicData *> &samples,
+        std::vector<dds::sub::SampleInfo *> &infos)
+{
+    std::unique_ptr<dds::core::xtypes::DynamicData> sample =
+            get_pooled_sample();
+    SampleConverter::from_document(
+            *sample,
+            document["data"].get_document().view());
+
+    std::unique_ptr<dds::sub::SampleInfo> info = get_pooled_info();
+    if (document["info"]) {
+        SampleConverter::from_document(
+                *info,
+                document["info"].get_document().view());
+    } else {
+        DDS_SampleInfo native_info = DDS_SAMPLEINFO_DEFAULT;
+        native_info.valid_data = DDS_BOOLEAN_TRUE;
+        (*info)->native() = native_info;
+    }
+
+    samples.push_back(sample.release());
+    infos.push_back(info.release());
+}
+
+std::unique_ptr<dds::core::xtypes::DynamicData>
+        MongoStreamReader::get_pooled_sample()
+{
+    {
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        if (!sample_pool_.empty()) {
+            std::unique_ptr<dds::core::xtypes::DynamicData> sample =
+                    std::move(sample_pool_.back());
+            sample_pool_.pop_back();
+            // The documents may not have all the members of the type
+            sample->clear_all_members();
+            return sample;
+        }
+    }
+
+    // The pool grows up to the max number of samples loaned at once
+    return std::unique_ptr<dds::core::xtypes::DynamicData>(
+            new dds::core::xtypes::DynamicData(type_));
+}
+
+std::unique_ptr<dds::sub::SampleInfo> MongoStreamReader::get_pooled_info()
+{
+    {
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        if (!info_pool_.empty()) {
+            std::unique_ptr<dds::sub::SampleInfo> info =
+                    std::move(info_pool_.back());
+            info_pool_.pop_back();
+            return info;
+        }
+    }
+
+    return std::unique_ptr<dds::sub::SampleInfo>(new dds::sub::SampleInfo);
 }
 
 /*
@@ -67,6 +376,11 @@ void MongoStreamReader::take(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
 {
+    if (change_stream_mode_) {
+        take_pending_documents(samples, infos);
+        return;
+    }
+
     auto client = connection_.client();
     mongocxx::database database = client->database(connection_.db_name());
 
@@ -75,10 +389,7 @@ void MongoStreamReader::take(
                     .find(find_filter(), MongoStreamReader::find_options());
 
     for (const bsoncxx::document::view &document : cursor) {
-        samples.push_back(new dds::core::xtypes::DynamicData(type_));
-        SampleConverter::from_document(
-                *samples.back(),
-                document["data"].get_document().view());
+        take_document(document, samples, infos);
     }
 }
 
@@ -86,10 +397,14 @@ void MongoStreamReader::return_loan(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
 {
-    for (uint32_t i = 0; i < samples.size(); ++i) {
-        delete samples[i];
-        if (i < infos.size()) {
-            delete infos[i];
+    {
+        // The samples go back to the pool to be reused by the next take()
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        for (auto sample : samples) {
+            sample_pool_.emplace_back(sample);
+        }
+        for (auto info : infos) {
+            info_pool_.emplace_back(info);
         }
     }
     samples.resize(0);
@@ -13,6 +13,15 @@
 #define MONGO_MONGOSTREAMREADER_HPP
 
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include <mongocxx/change_stream.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/cursor.hpp>
 #include <rti/routing/adapter/AdapterPlugin.hpp>
@@ -30,7 +39,9 @@ namespace rti { namespace community { namespace examples {
  * as as part of a collection identified by the associated stream name. This
  * class is responsible for converting a sample from a mongocxx:document that
  * has a structure {data: {}, info: {}} into a stream smpale (represented as a
- * pair [DynamicData,SampleInfo]).
+ * pair [DynamicData,SampleInfo]). The SampleInfo is rebuilt from the info
+ * subdocument. The samples and infos returned by take() are reused by the
+ * following ones once their loan is returned.
  *
  * The samples are read from the database where the parent Connection is
  * connected and from the collection identified by the stream name.
@@ -45,17 +56,21 @@ namespace rti { namespace community { namespace examples {
  * the parent factory MongoConnection, which is provided on object construction,
  * an uses a cursor with a filter to satisfy the time condition above.
  *
- * A key behavior aspect of this class is its absence of asynchronous data
- * available notifications. The current implementation relies on periodic
- * polling from the parent Route, which must enable the periodic action and have
- * a Processor that class take() upon dispatch of such event.
+ * The StreamReader has two modes, selected with MongoConfig::READ_MODE:
  *
- * Therefore, this class makes no use of the StreamReaderListener that
- * RoutingService provides to listen for asynchronous notifications. A possible
- * enhancement of this implementation could be to create a
- * mongocxx::change_stream to listen for changes in the DB, and generate data
- * available notifications based on that.
+ * - poll (default): there are no asynchronous data available notifications.
+ * The reader relies on periodic polling from the parent Route, which must
+ * enable the periodic action and have a Processor that calls take() upon
+ * dispatch of such event. Each take() runs the query above.
  *
+ * - change_stream: a thread watches the collection with a
+ * mongocxx::change_stream, queues the inserted documents and notifies the
+ * StreamReaderListener that RoutingService provides, so the Route reads them
+ * as soon as they're inserted, with no queries while the collection is idle.
+ * The thread keeps the resume token of the last change, which resumes the
+ * change stream where it left off after an error. If the change stream can't
+ * be resumed, the thread opens a new one and catches up with the documents
+ * inserted meanwhile with a range query on the reception timestamp.
  */
 class MongoStreamReader
         : public rti::routing::adapter::DynamicDataStreamReader {
@@ -69,12 +84,21 @@ public:
      *      Information for the associated Stream, provided by Routing Service.
      * @param properties
      *      Configuration properites provided by the <property> tag within
-     *      <output>.
+     *      <input>.
+     * @param listener
+     *      Listener notified when documents are available, in change_stream
+     *      mode.
      */
     MongoStreamReader(
             MongoConnection &connection,
             const rti::routing::StreamInfo &stream_info,
-            const rti::routing::PropertySet &properties);
+            const rti::routing::PropertySet &properties,
+            rti::routing::adapter::StreamReaderListener *listener);
+
+    /**
+     * @brief Stops the change stream thread, if any.
+     */
+    ~MongoStreamReader();
 
     /*
      * --- StreamREader interface
@@ -110,7 +134,8 @@ public:
                  std::vector<dds::sub::SampleInfo *> &infos) override final;
 
     /**
-     * @brief Returns the memory used to generate the output samples in take().
+     * @brief Returns the output samples and infos of take() to the pools of
+     * the StreamReader.
      */
     void return_loan(
             std::vector<dds::core::xtypes::DynamicData *> &samples,
@@ -120,10 +145,77 @@ private:
     bsoncxx::document::value find_filter();
     static mongocxx::options::find find_options();
 
+    /**
+     * @brief Converts a {data: {}, info: {}} document into a sample and info
+     * from the pools, which are added to the output of take().
+     */
+    void take_document(
+            bsoncxx::document::view document,
+            std::vector<dds::core::xtypes::DynamicData *> &samples,
+            std::vector<dds::sub::SampleInfo *> &infos);
+
+    void take_pending_documents(
+            std::vector<dds::core::xtypes::DynamicData *> &samples,
+            std::vector<dds::sub::SampleInfo *> &infos);
+
+    /**
+     * @brief Returns a sample from sample_pool_, or a new one if the pool is
+     * empty.
+     */
+    std::unique_ptr<dds::core::xtypes::DynamicData> get_pooled_sample();
+
+    /**
+     * @brief Returns a SampleInfo from info_pool_, or a new one if the pool is
+     * empty.
+     */
+    std::unique_ptr<dds::sub::SampleInfo> get_pooled_info();
+
+    /*
+     * --- Change stream mode
+     * ---------------------------------------------------------
+     */
+    void change_stream_thread();
+
+    /**
+     * @brief Opens the change stream of the collection, resuming after
+     * resume_token_ if set, or catching up with a query otherwise.
+     *
+     * @param resuming
+     *      Set to whether the change stream resumes after resume_token_
+     */
+    mongocxx::change_stream watch(
+            mongocxx::collection &collection,
+            bool &resuming);
+
+    void catch_up(mongocxx::collection &collection);
+
+    bool push_document(bsoncxx::document::view document);
+
     MongoConnection &connection_;
     std::string stream_name_;
     bsoncxx::types::b_date last_read_;
     dds::core::xtypes::DynamicType type_;
+    // Samples and infos whose loan was returned, reused by take()
+    std::vector<std::unique_ptr<dds::core::xtypes::DynamicData>> sample_pool_;
+    std::vector<std::unique_ptr<dds::sub::SampleInfo>> info_pool_;
+    std::mutex sample_pool_mutex_;
+
+    rti::routing::adapter::StreamReaderListener *listener_;
+    bool change_stream_mode_;
+    // Documents received by the change stream thread, not taken yet
+    std::mutex pending_mutex_;
+    std::condition_variable pending_condition_;
+    std::deque<bsoncxx::document::value> pending_documents_;
+    // Last change received, to resume the change stream after an error
+    bsoncxx::stdx::optional<bsoncxx::document::value> resume_token_;
+    // Raw _ids of the documents reported with the timestamp last_read_, which
+    // the catch-up query reports again
+    std::unordered_set<std::string> last_read_ids_;
+    // Raw _ids of the documents of the last catch-up, which the change stream
+    // may also report
+    std::unordered_set<std::string> caught_up_ids_;
+    std::atomic<bool> stop_change_stream_thread_;
+    std::thread change_stream_thread_;
 };
 
 }}}  // namespace rti::community::examples
@@ -10,10 +10,22 @@
  * use or inability to use the software.
  */
 
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+#include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+#include <dds/sub/status/DataState.hpp>
+#include <mongocxx/bulk_write.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
 #include <mongocxx/database.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/model/delete_one.hpp>
+#include <mongocxx/model/replace_one.hpp>
+#include <mongocxx/write_concern.hpp>
 #include <rti/core/Exception.hpp>
 #include <rti/routing/Logger.hpp>
 #include <rti/topic/to_string.hpp>
@@ -29,13 +41,472 @@ using namespace bsoncxx;
 MongoStreamWriter::MongoStreamWriter(
         MongoConnection &connection,
         const StreamInfo &stream_info,
-        const PropertySet &)
-        : connection_(connection), stream_name_(stream_info.stream_name())
+        const PropertySet &properties)
+        : connection_(connection),
+          stream_name_(stream_info.stream_name()),
+          data_plan_(
+                  stream_info.type_info().dynamic_type(),
+                  MongoConfig::parse<
+                          MongoConfig::WRITE_BINARY_COLLECTIONS,
+                          bool>(properties)),
+          batch_size_(
+                  MongoConfig::parse<MongoConfig::WRITE_BATCH_SIZE, int32_t>(
+                          properties)),
+          linger_(MongoConfig::parse<MongoConfig::WRITE_LINGER_MS, int32_t>(
+                  properties)),
+          time_series_(
+                  MongoConfig::parse<MongoConfig::WRITE_TIME_SERIES, bool>(
+                          properties)),
+          upsert_(MongoConfig::parse<MongoConfig::WRITE_MODE>(properties)
+                  == "upsert"),
+          stop_linger_thread_(false),
+          queue_size_(
+                  MongoConfig::parse<MongoConfig::WRITE_QUEUE_SIZE, int32_t>(
+                          properties)),
+          queued_documents_(0),
+          stop_workers_(false),
+          metrics_(),
+          metrics_period_(
+                  MongoConfig::parse<
+                          MongoConfig::WRITE_METRICS_PERIOD_MS,
+                          int32_t>(properties)),
+          last_metrics_log_(std::chrono::steady_clock::now())
 {
+    /*
+     * With unordered inserts the server keeps inserting the rest of the batch
+     * when a document fails, and can apply the batch in parallel.
+     */
+    insert_options_.ordered(false);
+    /*
+     * The writes of an instance must be applied in order, so a disposal isn't
+     * undone by an earlier update of the same batch.
+     */
+    bulk_options_.ordered(true);
+    // Without the property, the write concern of the connection URI applies
+    if (properties.find(MongoConfig::name<MongoConfig::WRITE_CONCERN>())
+        != properties.end()) {
+        mongocxx::write_concern write_concern = MongoConfig::parse<
+                MongoConfig::WRITE_CONCERN,
+                mongocxx::write_concern>(properties);
+        insert_options_.write_concern(write_concern);
+        bulk_options_.write_concern(write_concern);
+    }
+
+    if (upsert_ && time_series_) {
+        throw dds::core::InvalidArgumentError(
+                "property " + MongoConfig::name<MongoConfig::WRITE_MODE>()
+                + "=upsert is not supported by time-series collections");
+    }
+
+    find_key_members(stream_info.type_info().dynamic_type());
+    if (upsert_ && key_members_.empty()) {
+        // Every sample would replace the same document
+        throw dds::core::InvalidArgumentError(
+                "property " + MongoConfig::name<MongoConfig::WRITE_MODE>()
+                + "=upsert requires a type with @key members, stream: "
+                + stream_info.stream_name());
+    }
+    prepare_collection(
+            MongoConfig::parse<MongoConfig::WRITE_EXPIRE_AFTER_S, int32_t>(
+                    properties));
+
+    int32_t worker_count =
+            MongoConfig::parse<MongoConfig::WRITE_WORKERS, int32_t>(
+                    properties);
+    if (upsert_ && worker_count > 1) {
+        // Concurrent workers could apply the batches of an instance out of order
+        rti::routing::Logger::instance().warn(
+                "upsert mode uses a single write worker for stream: "
+                + stream_info.stream_name());
+        worker_count = 1;
+    }
+    for (int32_t i = 0; i < worker_count; ++i) {
+        worker_threads_.push_back(
+                std::thread(&MongoStreamWriter::worker_thread, this));
+    }
+    if (linger_.count() > 0) {
+        linger_thread_ = std::thread(&MongoStreamWriter::linger_thread, this);
+    }
+
     rti::routing::Logger::instance().local(
             "created StreamWriter for stream: " + stream_info.stream_name());
 }
 
+MongoStreamWriter::~MongoStreamWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stop_linger_thread_ = true;
+    }
+    pending_condition_.notify_all();
+    if (linger_thread_.joinable()) {
+        linger_thread_.join();
+    }
+
+    std::vector<bsoncxx::document::value> documents;
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        documents = take_pending_documents();
+    }
+    dispatch_documents(documents);
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_workers_ = true;
+    }
+    queue_condition_.notify_all();
+    for (std::thread &worker : worker_threads_) {
+        worker.join();
+    }
+
+    log_metrics();
+}
+
+MongoStreamWriter::Metrics MongoStreamWriter::metrics()
+{
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+    std::lock_guard<std::mutex> metrics_lock(metrics_mutex_);
+    Metrics metrics = metrics_;
+    metrics.queue_depth = queued_documents_;
+    return metrics;
+}
+
+void MongoStreamWriter::log_metrics()
+{
+    Metrics current = metrics();
+    std::ostringstream string_stream;
+    string_stream << "write metrics of collection=" << stream_name_
+                  << ": queue_depth=" << current.queue_depth
+                  << ", max_queue_depth=" << current.max_queue_depth
+                  << ", inserts=" << current.inserts
+                  << ", failed_inserts=" << current.failed_inserts
+                  << ", inserted_documents=" << current.inserted_documents
+                  << ", failed_documents=" << current.failed_documents
+                  << ", mean_insert_latency_us="
+                  << (current.inserts > 0
+                              ? current.total_insert_latency.count()
+                                      / current.inserts
+                              : 0)
+                  << ", max_insert_latency_us="
+                  << current.max_insert_latency.count();
+    rti::routing::Logger::instance().local(string_stream.str());
+}
+
+std::vector<bsoncxx::document::value>
+        MongoStreamWriter::take_pending_documents()
+{
+    std::vector<bsoncxx::document::value> documents;
+    documents.swap(pending_documents_);
+    return documents;
+}
+
+std::vector<bsoncxx::document::value>
+        MongoStreamWriter::take_queued_documents()
+{
+    std::vector<bsoncxx::document::value> documents;
+    documents.swap(write_queue_.front());
+    write_queue_.pop_front();
+    while (!write_queue_.empty()
+           && documents.size() + write_queue_.front().size() <= batch_size_) {
+        std::move(
+                write_queue_.front().begin(),
+                write_queue_.front().end(),
+                std::back_inserter(documents));
+        write_queue_.pop_front();
+    }
+    queued_documents_ -= documents.size();
+    return documents;
+}
+
+void MongoStreamWriter::dispatch_documents(
+        std::vector<bsoncxx::document::value> &documents)
+{
+    if (documents.empty()) {
+        return;
+    }
+    if (worker_threads_.empty()) {
+        insert_documents(documents);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    // A batch larger than the queue is accepted once the queue is empty
+    queue_not_full_condition_.wait(lock, [this, &documents]() {
+        return queued_documents_ == 0
+                || queued_documents_ + documents.size() <= queue_size_;
+    });
+    queued_documents_ += documents.size();
+    write_queue_.push_back(std::move(documents));
+    {
+        std::lock_guard<std::mutex> metrics_lock(metrics_mutex_);
+        metrics_.max_queue_depth =
+                std::max(metrics_.max_queue_depth, queued_documents_);
+    }
+    lock.unlock();
+    queue_condition_.notify_one();
+}
+
+void MongoStreamWriter::insert_documents(
+        std::vector<bsoncxx::document::value> &documents)
+{
+    if (documents.empty()) {
+        return;
+    }
+
+    try {
+        /*
+         * This is a blocking operation: calling client() will query the
+         * mongo pool and wait until a client is available.
+         */
+        auto client = connection_.client();
+        mongocxx::database database = client->database(connection_.db_name());
+        mongocxx::collection db_collection = database[stream_name_];
+
+        insert_documents(db_collection, documents);
+    } catch (const mongocxx::exception &ex) {
+        rti::routing::Logger::instance().error(
+                "cannot get a client to insert into collection "
+                + stream_name_ + ": " + ex.what());
+        count_failed_insert(documents.size());
+    }
+}
+
+void MongoStreamWriter::count_failed_insert(size_t document_count)
+{
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    ++metrics_.inserts;
+    ++metrics_.failed_inserts;
+    metrics_.failed_documents += document_count;
+}
+
+void MongoStreamWriter::insert_documents(
+        mongocxx::collection &collection,
+        std::vector<bsoncxx::document::value> &documents)
+{
+    bool failed = false;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        if (upsert_) {
+            upsert_documents(collection, documents);
+        } else {
+            collection.insert_many(documents, insert_options_);
+        }
+    } catch (const mongocxx::exception &ex) {
+        failed = true;
+        rti::routing::Logger::instance().error(
+                "failed to write " + std::to_string(documents.size())
+                + " documents into collection " + stream_name_ + ": "
+                + ex.what());
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::microseconds latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start);
+
+    bool log = false;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        ++metrics_.inserts;
+        if (failed) {
+            ++metrics_.failed_inserts;
+            metrics_.failed_documents += documents.size();
+        } else {
+            metrics_.inserted_documents += documents.size();
+        }
+        metrics_.total_insert_latency += latency;
+        metrics_.max_insert_latency =
+                std::max(metrics_.max_insert_latency, latency);
+        if (metrics_period_.count() > 0
+            && now - last_metrics_log_ >= metrics_period_) {
+            last_metrics_log_ = now;
+            log = true;
+        }
+    }
+    if (log) {
+        log_metrics();
+    }
+}
+
+void MongoStreamWriter::upsert_documents(
+        mongocxx::collection &collection,
+        std::vector<bsoncxx::document::value> &documents)
+{
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    mongocxx::bulk_write bulk = collection.create_bulk_write(bulk_options_);
+    for (const bsoncxx::document::value &document : documents) {
+        document::view view = document.view();
+        bsoncxx::document::value filter =
+                make_document(kvp("_id", view["_id"].get_value()));
+        // The documents of disposed instances only have the _id
+        if (view.find("data") == view.end()) {
+            bulk.append(mongocxx::model::delete_one(filter.view()));
+        } else {
+            mongocxx::model::replace_one replace(filter.view(), view);
+            replace.upsert(true);
+            bulk.append(replace);
+        }
+    }
+    bulk.execute();
+}
+
+void MongoStreamWriter::find_key_members(
+        const dds::core::xtypes::DynamicType &type)
+{
+    using namespace dds::core::xtypes;
+
+    const DynamicType resolved_type = rti::core::xtypes::resolve_alias(type);
+    if (resolved_type.kind() != TypeKind::STRUCTURE_TYPE) {
+        return;
+    }
+    const StructType &struct_type =
+            static_cast<const StructType &>(resolved_type);
+    for (uint32_t i = 0; i < struct_type.member_count(); ++i) {
+        const Member &member = struct_type.member(i);
+        if (member.is_key()) {
+            key_members_.push_back(member.name());
+        }
+    }
+}
+
+bsoncxx::document::value MongoStreamWriter::instance_id(
+        document::view data) const
+{
+    using bsoncxx::builder::basic::kvp;
+
+    builder::basic::document id {};
+    for (const std::string &key_member : key_members_) {
+        document::element element = data[key_member];
+        if (element) {
+            id.append(kvp(key_member, element.get_value()));
+        }
+    }
+    return id.extract();
+}
+
+void MongoStreamWriter::prepare_collection(int32_t expire_after_seconds)
+{
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    try {
+        auto client = connection_.client();
+        mongocxx::database database = client->database(connection_.db_name());
+
+        if (time_series_ && !database.has_collection(stream_name_)) {
+            builder::basic::document options {};
+            options.append(kvp(
+                    "timeseries",
+                    make_document(kvp("timeField", "timestamp"))));
+            if (expire_after_seconds > 0) {
+                options.append(
+                        kvp("expireAfterSeconds", expire_after_seconds));
+            }
+            database.create_collection(stream_name_, options.extract());
+        }
+
+        mongocxx::collection collection = database.collection(stream_name_);
+        mongocxx::options::index timestamp_options {};
+        if (!time_series_ && expire_after_seconds > 0) {
+            timestamp_options.expire_after(
+                    std::chrono::seconds(expire_after_seconds));
+        }
+        collection.create_index(
+                make_document(kvp("info.reception_timestamp", 1)),
+                timestamp_options);
+
+        if (!key_members_.empty()) {
+            builder::basic::document key_index {};
+            for (const std::string &key_member : key_members_) {
+                key_index.append(kvp("data." + key_member, 1));
+            }
+            key_index.append(kvp("info.reception_timestamp", 1));
+            collection.create_index(key_index.extract());
+        }
+    } catch (const mongocxx::exception &ex) {
+        rti::routing::Logger::instance().error(
+                "cannot create the indexes of collection=" + stream_name_
+                + ": " + ex.what());
+    }
+}
+
+void MongoStreamWriter::linger_thread()
+{
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    while (!stop_linger_thread_) {
+        if (pending_documents_.empty()) {
+            pending_condition_.wait(lock);
+            continue;
+        }
+
+        auto deadline = first_pending_time_ + linger_;
+        if (std::chrono::steady_clock::now() < deadline) {
+            pending_condition_.wait_until(lock, deadline);
+            continue;
+        }
+
+        /*
+         * The pending lock is released to take the dispatch lock first, so
+         * the pending documents are taken again in case write() has
+         * dispatched them meanwhile.
+         */
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+            std::vector<bsoncxx::document::value> documents;
+            {
+                std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+                documents = take_pending_documents();
+            }
+            dispatch_documents(documents);
+        }
+        lock.lock();
+    }
+}
+
+void MongoStreamWriter::worker_thread()
+{
+    /*
+     * The client is held for the lifetime of the worker, so queued batches
+     * don't wait for the pool. It's acquired again if that failed.
+     */
+    mongocxx::pool::entry client;
+    mongocxx::collection collection;
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        queue_condition_.wait(lock, [this]() {
+            return stop_workers_ || !write_queue_.empty();
+        });
+        if (write_queue_.empty()) {
+            // Deleted, and all the queued documents have been inserted
+            break;
+        }
+
+        std::vector<bsoncxx::document::value> documents =
+                take_queued_documents();
+        lock.unlock();
+        queue_not_full_condition_.notify_all();
+
+        try {
+            if (!client) {
+                client = connection_.client();
+                collection = client->database(connection_.db_name())
+                                     .collection(stream_name_);
+            }
+            insert_documents(collection, documents);
+        } catch (const mongocxx::exception &ex) {
+            client = mongocxx::pool::entry {};
+            rti::routing::Logger::instance().error(
+                    "cannot get a client to insert into collection "
+                    + stream_name_ + ": " + ex.what());
+            count_failed_insert(documents.size());
+        }
+        lock.lock();
+    }
+}
+
 
 /*
  * --- Adapter Interface ------------------------------------------------------
@@ -45,27 +516,61 @@ int MongoStreamWriter::write(
         const std::vector<dds::core::xtypes::DynamicData *> &samples,
         const std::vector<dds::sub::SampleInfo *> &infos)
 {
-    /*
-     * This is a blocking operation: calling database() will query the
-     * mongo pool and wait until a client is available.
-     * We will keep the obtained client locked to write all the sample sequence
-     */
-    auto client = connection_.client();
-    mongocxx::database database = client->database(connection_.db_name());
-    mongocxx::collection db_collection = database[stream_name_];
-
+    // Held while dispatching, so the batches are dispatched in order
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    std::unique_lock<std::mutex> lock(pending_mutex_);
     for (uint32_t i = 0; i < samples.size(); i++) {
+        bsoncxx::document::value data = data_plan_.to_document(*samples[i]);
         builder::stream::document document_sample {};
-        document_sample << "data"
-                        << types::b_document { SampleConverter::to_document(
-                                   *samples[i]) };
-        if (infos[i] != NULL) {
+        if (upsert_) {
+            document_sample << "_id"
+                            << types::b_document { instance_id(data.view()) };
+        }
+        bool disposed = infos[i] != NULL
+                && (*infos[i])->state().instance_state()
+                        == dds::sub::status::InstanceState::
+                                not_alive_disposed();
+        if (!upsert_ || !disposed) {
+            document_sample << "data" << types::b_document { data.view() };
+        }
+        if (infos[i] != NULL && (!upsert_ || !disposed)) {
             document_sample << "info"
                             << types::b_document { SampleConverter::to_document(
                                        *infos[i]) };
         }
+        if (time_series_) {
+            // The time field of a time-series collection must be top-level
+            types::b_date timestamp { std::chrono::system_clock::now() };
+            if (infos[i] != NULL) {
+                timestamp = types::b_date { std::chrono::milliseconds(
+                        (*infos[i])->reception_timestamp().to_millisecs()) };
+            }
+            document_sample << "timestamp" << timestamp;
+        }
+
+        if (pending_documents_.empty()) {
+            first_pending_time_ = std::chrono::steady_clock::now();
+        }
+        pending_documents_.push_back(
+                document_sample << builder::stream::finalize);
+
+        if (pending_documents_.size() >= batch_size_) {
+            std::vector<bsoncxx::document::value> documents =
+                    take_pending_documents();
+            lock.unlock();
+            dispatch_documents(documents);
+            lock.lock();
+        }
+    }
 
-        db_collection.insert_one(document_sample << builder::stream::finalize);
+    if (linger_.count() > 0) {
+        // The linger thread inserts the documents that don't complete a batch
+        pending_condition_.notify_one();
+    } else {
+        std::vector<bsoncxx::document::value> documents =
+                take_pending_documents();
+        lock.unlock();
+        dispatch_documents(documents);
     }
 
     return samples.size();
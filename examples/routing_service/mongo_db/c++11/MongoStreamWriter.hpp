@@ -13,11 +13,23 @@
 #ifndef MONGO_STREAMWRITER_HPP
 #define MONGO_STREAMWRITER_HPP
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include <bsoncxx/document/value.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/insert.hpp>
 #include <rti/routing/adapter/AdapterPlugin.hpp>
 #include <rti/routing/adapter/StreamWriter.hpp>
 
+#include "DocumentPlan.hpp"
 #include "MongoConnection.hpp"
 
 namespace rti { namespace community { namespace examples {
@@ -33,10 +45,78 @@ namespace rti { namespace community { namespace examples {
  *
  * To perform database insertions, this class obtains a client handle through
  * the parent factory MongoConnection, which is provided on object construction.
+ *
+ * Documents are inserted in batches with unordered insert_many operations, so
+ * a single round trip to the database stores up to
+ * MongoConfig::WRITE_BATCH_SIZE samples. The client handle is held only while
+ * a batch is inserted. When MongoConfig::WRITE_LINGER_MS is set, the documents
+ * that don't complete a batch are kept across write() calls, and a linger
+ * thread inserts them once they have waited that long.
+ *
+ * With MongoConfig::WRITE_WORKERS, the batches are inserted asynchronously:
+ * write() hands them to a queue of up to MongoConfig::WRITE_QUEUE_SIZE
+ * documents, and returns without waiting for the database. Worker threads,
+ * each holding its own client of the connection pool, take the queued batches
+ * and insert them, merging the small ones up to MongoConfig::WRITE_BATCH_SIZE.
+ * When the queue is full, write() blocks until the workers make room, so the
+ * memory used is bounded. The client pool must allow a client per worker, in
+ * addition to the ones of the rest of the streams.
+ *
+ * The StreamWriter keeps Metrics of the queue and the insertions, which are
+ * logged every MongoConfig::WRITE_METRICS_PERIOD_MS and when it's deleted.
+ *
+ * On creation, the StreamWriter creates the indexes that keep the queries and
+ * the expiration of documents fast as the collection grows:
+ * - info.reception_timestamp, used by the MongoStreamReader queries, and as
+ *   TTL index with MongoConfig::WRITE_EXPIRE_AFTER_S.
+ * - The @key members of the type, followed by info.reception_timestamp, for
+ *   the queries on the history of an instance.
+ * With MongoConfig::WRITE_TIME_SERIES, the collection is created beforehand as
+ * a time-series collection.
+ *
+ * With MongoConfig::WRITE_MODE set to "upsert", the collection keeps only the
+ * last sample of each instance. The _id of its document is a document with
+ * the @key members of the sample, and each batch is written with an ordered
+ * bulk_write of replace_one operations with upsert. The samples of disposed
+ * instances become delete_one operations instead.
+ *
+ * The MongoStreamWriter can receive the following configuration properties:
+ *
+ *  - MongoConfig::WRITE_BATCH_SIZE
+ *  - MongoConfig::WRITE_LINGER_MS
+ *  - MongoConfig::WRITE_CONCERN
+ *  - MongoConfig::WRITE_BINARY_COLLECTIONS
+ *  - MongoConfig::WRITE_TIME_SERIES
+ *  - MongoConfig::WRITE_EXPIRE_AFTER_S
+ *  - MongoConfig::WRITE_WORKERS
+ *  - MongoConfig::WRITE_QUEUE_SIZE
+ *  - MongoConfig::WRITE_METRICS_PERIOD_MS
+ *  - MongoConfig::WRITE_MODE
  */
 class MongoStreamWriter
         : public rti::routing::adapter::DynamicDataStreamWriter {
 public:
+    /**
+     * @brief Metrics of the insertions of a StreamWriter.
+     */
+    struct Metrics {
+        // Documents waiting in the queue of the workers
+        size_t queue_depth;
+        // Highest queue_depth so far
+        size_t max_queue_depth;
+        // insert_many operations (bulk_write in upsert mode), and how many
+        // of them failed
+        uint64_t inserts;
+        uint64_t failed_inserts;
+        // Documents written, and documents of the failed operations, some of
+        // which may have been written anyway
+        uint64_t inserted_documents;
+        uint64_t failed_documents;
+        // Duration of the operations
+        std::chrono::microseconds total_insert_latency;
+        std::chrono::microseconds max_insert_latency;
+    };
+
     /**
      * @brief Creates the StreamWriter from the required parameters.
      *
@@ -53,6 +133,17 @@ public:
             const rti::routing::StreamInfo &stream_info,
             const rti::routing::PropertySet &properties);
 
+    /**
+     * @brief Stops the linger thread and inserts the pending documents, then
+     * waits for the workers to insert the queued documents.
+     */
+    ~MongoStreamWriter();
+
+    /**
+     * @brief Returns a snapshot of the metrics of the insertions.
+     */
+    Metrics metrics();
+
     /*
      * --- StreamWriter interface
      * ---------------------------------------------------------
@@ -74,6 +165,10 @@ public:
      * where _bson{samples[i]}_ is the BSON representation of a DDS data item
      * and _bson_{infos[i]} is the BSON representation of a DDS info item.
      *
+     * The documents are inserted in batches of up to
+     * MongoConfig::WRITE_BATCH_SIZE. Without linger nor workers, all of them
+     * are inserted before returning.
+     *
      * @see SampleConverter
      *
      */
@@ -82,8 +177,123 @@ public:
             const std::vector<dds::sub::SampleInfo *> &infos) override final;
 
 private:
+    /**
+     * @brief Creates the time-series collection, if configured, and the
+     * indexes of the collection. Failures are logged, since the documents can
+     * be inserted without them.
+     */
+    void prepare_collection(int32_t expire_after_seconds);
+
+    /**
+     * @brief Finds the names of the @key members of the type of the stream.
+     */
+    void find_key_members(const dds::core::xtypes::DynamicType &type);
+
+    /**
+     * @brief Returns the _id of the document of an instance in upsert mode:
+     * a document with the key members of the converted sample.
+     */
+    bsoncxx::document::value instance_id(bsoncxx::document::view data) const;
+
+    /**
+     * @brief Replaces the documents of their instances, inserting them if
+     * they don't exist, and deletes the instances of the documents that only
+     * have an _id. Throws mongocxx::exception when the bulk_write fails.
+     */
+    void upsert_documents(
+            mongocxx::collection &collection,
+            std::vector<bsoncxx::document::value> &documents);
+
+    /**
+     * @brief Queues the documents for the workers, or inserts them right away
+     * if there are no workers. Blocks while the queue is full. Requires
+     * dispatch_mutex_, so the batches are taken and dispatched in order.
+     */
+    void dispatch_documents(std::vector<bsoncxx::document::value> &documents);
+
+    /**
+     * @brief Inserts the documents with a client of the connection pool.
+     */
+    void insert_documents(std::vector<bsoncxx::document::value> &documents);
+
+    /**
+     * @brief Inserts the documents with a single unordered insert_many, or
+     * writes them with upsert_documents() in upsert mode, and updates the
+     * metrics. Failures are logged, and the documents that could be written
+     * remain in the database.
+     */
+    void insert_documents(
+            mongocxx::collection &collection,
+            std::vector<bsoncxx::document::value> &documents);
+
+    /**
+     * @brief Counts the documents that couldn't be inserted for lack of a
+     * client as a failed insert_many.
+     */
+    void count_failed_insert(size_t document_count);
+
+    /**
+     * @brief Takes queued batches up to WRITE_BATCH_SIZE documents, or a
+     * single larger batch. Requires queue_mutex_.
+     */
+    std::vector<bsoncxx::document::value> take_queued_documents();
+
+    /**
+     * @brief Moves the pending documents out, so they can be inserted without
+     * holding the pending lock. Requires pending_mutex_.
+     */
+    std::vector<bsoncxx::document::value> take_pending_documents();
+
+    void linger_thread();
+
+    /**
+     * @brief Inserts the queued documents until the StreamWriter is deleted
+     * and the queue is empty.
+     */
+    void worker_thread();
+
+    void log_metrics();
+
     MongoConnection &connection_;
     std::string stream_name_;
+    // Compiled once for the type of the stream
+    DocumentPlan data_plan_;
+    size_t batch_size_;
+    std::chrono::milliseconds linger_;
+    mongocxx::options::insert insert_options_;
+    mongocxx::options::bulk_write bulk_options_;
+    bool time_series_;
+    bool upsert_;
+    std::vector<std::string> key_members_;
+
+    /*
+     * Held from taking the pending documents until they're dispatched, so
+     * write() and the linger thread can't reorder the batches. Locked before
+     * pending_mutex_.
+     */
+    std::mutex dispatch_mutex_;
+    // Documents waiting to complete a batch
+    std::mutex pending_mutex_;
+    std::vector<bsoncxx::document::value> pending_documents_;
+    std::chrono::steady_clock::time_point first_pending_time_;
+    std::condition_variable pending_condition_;
+    bool stop_linger_thread_;
+    std::thread linger_thread_;
+
+    // Batches waiting for the workers
+    size_t queue_size_;
+    std::mutex queue_mutex_;
+    std::deque<std::vector<bsoncxx::document::value>> write_queue_;
+    size_t queued_documents_;
+    std::condition_variable queue_condition_;
+    std::condition_variable queue_not_full_condition_;
+    bool stop_workers_;
+    std::vector<std::thread> worker_threads_;
+
+    std::mutex metrics_mutex_;
+    Metrics metrics_;
+    std::chrono::milliseconds metrics_period_;
+    std::chrono::steady_clock::time_point last_metrics_log_;
 };
 
 }}}  // namespace rti::community::examples
@@ -10,11 +10,16 @@
  * use or inability to use the software.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
 #include <dds/core/xtypes/CollectionTypes.hpp>
 #include <rti/routing/Logger.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <bsoncxx/builder/stream/array.hpp>
 
+#include "DocumentPlan.hpp"
 #include "SampleConverter.hpp"
 
 using namespace dds::core::xtypes;
@@ -31,500 +36,11 @@ using namespace rti::community::examples;
 /* --- DynamicData
  * --------------------------------------------------------------------*/
 
-/**
- * @brief Helper to add a primitive member to either a document or an array
- *
- * Template specializations are expected to have a single static set() operation
- * to perform the insertion.
- *
- * @tparam Primitive
- *      one of the valid DDS primitive types
- * @tparam DocOrArray
- *      Either a bsoncxx::document or  bsoncxx::array.
- */
-template<typename Primitive, typename DocOrArray>
-struct primitive_setter;
-
-template<typename Primitive>
-struct primitive_setter<Primitive, bsoncxx::builder::stream::document> {
-    /**
-     * @brief Obtains the value for the specified primitive member from _data_
-     * and adds it to a document.
-     *
-     * @param[in] data
-     *      DynamicData complex member containing the primitive member
-     * @param[in] member_info
-     *      Description of the primitive member. Must hold a valid member index
-     * and name.
-     * @param[out] document
-     *      Output document
-     */
-    static void set(
-            const dds::core::xtypes::DynamicData &data,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-            bsoncxx::builder::stream::document &document)
-    {
-        document << member_info.member_name()
-                 << data.value<Primitive>(member_info.member_index());
-    }
-};
-
-
-template<typename Primitive>
-struct primitive_setter<Primitive, bsoncxx::builder::stream::array> {
-    /**
-     * @brief Obtains the value for the specified sequence/array item from
-     * _data_ and adds it to an array.
-     *
-     * @param[in] data
-     *      DynamicData sequence.array member containing the primitive element.
-     * @param[in] member_info
-     *      Description of the primitive element. Must contain a valid member
-     * index.
-     * @param[out] array
-     *      Output array
-     */
-    static void set(
-            const dds::core::xtypes::DynamicData &data,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-            bsoncxx::builder::stream::array &array)
-    {
-        array << data.value<Primitive>(member_info.member_index());
-    }
-};
-
-/**
- * @brief Helper function to extra a primitive member or element from
- * DynamicData and inset it into a BSON document or array.
- */
-template<
-        typename Primitive,
-        typename DocOrArray = bsoncxx::builder::stream::document>
-void set_primitive(
-        const dds::core::xtypes::DynamicData &data,
-        const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-        DocOrArray &doc_or_array)
-{
-    primitive_setter<Primitive, DocOrArray>::set(
-            data,
-            member_info,
-            doc_or_array);
-}
-
-/**
- * @brief Helper function that obtains the value from the specified primitive
- * member and adds it to a bson document or an array.
- *
- * This operation selects the appropriate primitive_setter based on the TypeKind
- * of the primitive member. If the specified member is of an unsupported type,
- * this operation simply logs a message and returns.
- */
-template<typename DocOrArray = bsoncxx::builder::stream::document>
-void demultiplex_primitive_member(
-        const dds::core::xtypes::DynamicData &data,
-        const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-        DocOrArray &doc_or_array)
-{
-    using dds::core::xtypes::DynamicData;
-    using dds::core::xtypes::TypeKind;
-    using rti::core::xtypes::DynamicDataMemberInfo;
-
-    typedef std::function<void(
-            const DynamicData &,
-            const DynamicDataMemberInfo &,
-            DocOrArray &)>
-            FromPrimitiveFunc;
-    static std::unordered_map<int32_t, FromPrimitiveFunc> demux_table {
-        { TypeKind::BOOLEAN_TYPE, set_primitive<DDS_Boolean, DocOrArray> },
-        { TypeKind::CHAR_8_TYPE, set_primitive<DDS_Char, DocOrArray> },
-        { TypeKind::UINT_8_TYPE, set_primitive<uint8_t, DocOrArray> },
-        { TypeKind::INT_16_TYPE, set_primitive<int16_t, DocOrArray> },
-        { TypeKind::UINT_16_TYPE, set_primitive<uint16_t, DocOrArray> },
-        { TypeKind::INT_32_TYPE, set_primitive<int32_t, DocOrArray> },
-        { TypeKind::UINT_32_TYPE, set_primitive<int64_t, DocOrArray> },
-        { TypeKind::INT_64_TYPE, set_primitive<int64_t, DocOrArray> },
-        { TypeKind::ENUMERATION_TYPE, set_primitive<int32_t, DocOrArray> },
-        { TypeKind::STRING_TYPE, set_primitive<std::string, DocOrArray> },
-        { TypeKind::FLOAT_32_TYPE, set_primitive<float_t, DocOrArray> },
-        { TypeKind::FLOAT_64_TYPE, set_primitive<double, DocOrArray> }
-    };
-
-    typename std::unordered_map<int32_t, FromPrimitiveFunc>::iterator it =
-            demux_table.find(member_info.member_kind().underlying());
-    if (it == demux_table.end()) {
-        // log unsupported
-        std::ostringstream string_stream;
-        string_stream << "unsupported type for member="
-                      << member_info.member_name();
-        rti::routing::Logger::instance().debug(string_stream.str());
-        return;
-    }
-
-    it->second(data, member_info, doc_or_array);
-}
-
-/**
- * @brief Helper to add a BSON element to either a document or an array
- *
- * Template specializations are expected to have a single static set() operation
- * to perform the insertion.
- *
- * @tparam ElementType
- *      one of the valid bsoncxx::types
- * @tparam DocOrArray
- *      Either a bsoncxx::document or  bsoncxx::array.
- */
-template<typename ElementType, typename DocOrArray>
-struct element_setter;
-
-template<typename ElementType>
-struct element_setter<ElementType, bsoncxx::builder::stream::array> {
-    /**
-     * @brief Adds the specified element to a bson array.
-     *
-     * @param[in] element
-     *      Instance of a a valid BSON type.
-     * @param[in] member_info
-     *      Description of the element, as its associated DynamicData member
-     * @param[out] array
-     *      Output array
-     */
-    static void set(
-            ElementType &element,
-            const rti::core::xtypes::DynamicDataMemberInfo &,
-            bsoncxx::builder::stream::array &array)
-    {
-        array << element;
-    }
-};
-
-template<typename ElementType>
-struct element_setter<ElementType, bsoncxx::builder::stream::document> {
-    /**
-     * @brief Adds the specified element to a bson document.
-     *
-     * @param[in] element
-     *      Instance of a a valid BSON type.
-     * @param[in] member_info
-     *      Description of the element, as its associated DynamicData member
-     * @param[out] document
-     *      Output document
-     */
-    static void set(
-            ElementType &element,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-            bsoncxx::builder::stream::document &document)
-    {
-        document << member_info.member_name() << element;
-    }
-};
-
-/**
- * @brief Abstract class that represent a member context, used to build
- * a bsoncxx::document or bsoncxx::array from DynamicData.
- *
- * This class defines the behavior required by the build_document() operation in
- * order to keep track of the nesting level of a member and perform the proper
- * operation to add the member into an output bson document and array.
- */
-class ToBsonContext {
-public:
-    /**
-     * @brief Creates the context given the total number of members.
-     * The underlying _member_index_ is set to 1, the minimum valid index for a
-     * DynamicData member.
-     */
-    ToBsonContext(uint32_t the_member_count)
-            : member_index(1), member_count(the_member_count)
-    {
-    }
-
-    /**
-     * @brief Sets the primitive member for this  context.
-     *
-     * @param[in] data
-     *      The source DynamicData object
-     * @param[in] member_info
-     *      Description of the member inside _data_
-     */
-    virtual void set_primitive(
-            const dds::core::xtypes::DynamicData &data,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info) = 0;
-
-    /**
-     * @brief Sets a bson document in this context.
-     *
-     * @param[in] document
-     *      The source bson document
-     * @param[in] member_info
-     *      Description of the complex member
-     */
-    virtual void set_document(
-            bsoncxx::builder::stream::document &document,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info) = 0;
-
-    /**
-     * @brief Sets a bson array in this context.
-     *
-     * @param[in] array
-     *      The source bson array
-     * @param[in] member_info
-     *      Description of the array/sequence member
-     */
-    virtual void set_array(
-            bsoncxx::builder::stream::array &array,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info) = 0;
-
-    // @brief index of the member whose value is retrieved from the DynData
-    // object
-    uint32_t member_index;
-    // @brief total number of members belonging to this complex member context.
-    uint32_t member_count;
-};
-
-/**
- * @brief Implementation of the ToBsonContext that chooses the proper setter
- * specialization based on the destination document or array.
- *
- * The class provides a holder to a destination object instance that is either
- * bson document or array, based on the specialization.
- *
- * @tparam DocOrArray
- *      The type of the destination where members are set.
- */
-template<typename DocOrArray>
-class ToBsonTypedContext : public ToBsonContext {
-public:
-    /**
-     * @see  ToBsonContext(uint32_t)
-     */
-    ToBsonTypedContext(uint32_t the_member_count)
-            : ToBsonContext(the_member_count)
-    {
-    }
-
-    /**
-     * @brief calls demultiplex_primitive_member
-     */
-    void set_primitive(
-            const dds::core::xtypes::DynamicData &data,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info)
-            override
-    {
-        demultiplex_primitive_member(data, member_info, doc_or_array);
-    }
-
-    /**
-     * @brief calls element_setter<array>set()
-     */
-    void set_array(
-            bsoncxx::builder::stream::array &array,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info)
-            override
-    {
-        bsoncxx::types::b_array array_view { array };
-        element_setter<bsoncxx::types::b_array, DocOrArray>::set(
-                array_view,
-                member_info,
-                doc_or_array);
-    }
-
-    /***
-     * @brief calls element_setter<document>set()
-     */
-    void set_document(
-            bsoncxx::builder::stream::document &document,
-            const rti::core::xtypes::DynamicDataMemberInfo &member_info)
-            override
-    {
-        bsoncxx::types::b_document doc_view { document };
-        element_setter<bsoncxx::types::b_document, DocOrArray>::set(
-                doc_view,
-                member_info,
-                doc_or_array);
-    }
-
-    // @brief instance to the bson object destination
-    DocOrArray doc_or_array;
-};
-
-/**
- * @brief Specialization of ToBsonTypedContext for a bson document
- */
-typedef ToBsonTypedContext<bsoncxx::builder::stream::document>
-        ToDocumentContext;
-
-/**
- * @brief Specialization of ToBsonTypedContext for a bson array.
- *
- * The class also adds additional state needed to properly set items within the
- * destination array.
- */
-class ToArrayContext
-        : public ToBsonTypedContext<bsoncxx::builder::stream::array> {
-public:
-    ToArrayContext(
-            uint32_t the_member_index = 1,
-            std::vector<uint32_t> the_dimensions = {},
-            uint32_t the_dimension_index = 0,
-            uint32_t the_element_index = 1)
-            : ToBsonTypedContext<bsoncxx::builder::stream::array>(
-                    the_member_index),
-              dimensions(the_dimensions),
-              dimension_index(the_dimension_index),
-              element_index(the_element_index)
-    {
-        member_index = the_member_index;
-    }
-
-    // @brief current dimension for which elements are set
-    uint32_t dimension_index;
-    // @brief list of dimensions
-    std::vector<uint32_t> dimensions;
-    // @brief index within the destination array where the element is set
-    uint32_t element_index;
-};
-
-/***
- * @brief Builds a document from the content of the specified DynamicData
- * object.
- *
- * This is a recursive operation that traverses a DynamicData object using DFS
- * approach. It automatically generates the appropriate complex member–either
- * document or array– based on the type of each member.
- *
- * It is expected that the first call to this operation receives a
- * ToDocumentContext and the top-level DynamicData object. Subsequent operations
- * are self-made to build the full bson document.
- *
- * @param[in] context
- *      Current complex member context
- * @param[in] data
- *      DynamicData object holding the content for the complex or array member.
- * In recursive calls, this will be a loaned member.
- */
-inline void build_document(ToBsonContext &context, DynamicData &data)
-{
-    using bsoncxx::builder::stream::document;
-    using dds::core::xtypes::ArrayType;
-    using rti::core::xtypes::DynamicDataMemberInfo;
-    using rti::core::xtypes::LoanedDynamicData;
-
-    if (context.member_index == context.member_count + 1) {
-        // end of members/items
-        return;
-    }
-
-    // Handle sub-array state
-    if (typeid(context) == typeid(ToArrayContext)) {
-        ToArrayContext &as_array_context =
-                static_cast<ToArrayContext &>(context);
-        if (as_array_context.dimension_index
-            < as_array_context.dimensions.size()) {
-            uint32_t current_dimension = as_array_context.dimension_index;
-            // Arrays can have too many elements for a recursive approach, hence
-            // we iterate on the elements to avoid stack overflow
-            for (uint32_t i = 0;
-                 i < as_array_context.dimensions[current_dimension];
-                 ++i) {
-                if (as_array_context.dimension_index
-                    < as_array_context.dimensions.size() - 1) {
-                    ToArrayContext nested_context(
-                            as_array_context.element_index,
-                            as_array_context.dimensions,
-                            as_array_context.dimension_index + 1,
-                            as_array_context.element_index);
-                    build_document(nested_context, data);
-                    context.set_array(
-                            nested_context.doc_or_array,
-                            data.member_info(as_array_context.element_index));
-                    // advance the element iterator index
-                    as_array_context.element_index =
-                            nested_context.element_index;
-                } else {
-                    // mark the end of dimensions
-                    ++as_array_context.dimension_index;
-                    // Set member_count to allow only one recursion
-                    context.member_count = as_array_context.element_index;
-                    context.member_index = as_array_context.element_index;
-                    build_document(context, data);
-                    ++as_array_context.element_index;
-                }
-            }
-            // end of elements, at this point we have reached the maximum
-            // at the current dimension
-            return;
-        }
-    }
-
-    if (!data.member_exists(context.member_index)) {
-        ++context.member_index;
-        return build_document(context, data);
-    }
-
-    DynamicDataMemberInfo member_info = data.member_info(context.member_index);
-    switch (member_info.member_kind().underlying()) {
-    case TypeKind::STRUCTURE_TYPE: {
-        LoanedDynamicData loaned_member =
-                data.loan_value(member_info.member_index());
-        ToDocumentContext nested_context(loaned_member.get().member_count());
-        build_document(nested_context, loaned_member.get());
-        context.set_document(nested_context.doc_or_array, member_info);
-
-    } break;
-
-    case TypeKind::SEQUENCE_TYPE: {
-        LoanedDynamicData loaned_array =
-                data.loan_value(member_info.member_name());
-        // Sequences can have too many elements for a recursive approach, hence
-        // we iterate on the elements to avoid stack overflow
-        ToArrayContext nested_context(1);
-        for (uint32_t i = 0; i < member_info.element_count(); ++i) {
-            // Set member_count to allow only one recursion
-            nested_context.member_count = i;
-            build_document(nested_context, loaned_array.get());
-        }
-
-        context.set_array(nested_context.doc_or_array, member_info);
-    } break;
-
-    case TypeKind::ARRAY_TYPE: {
-        LoanedDynamicData loaned_array =
-                data.loan_value(member_info.member_name());
-        // Get dimensions as an array
-        const ArrayType &array_type =
-                static_cast<const ArrayType &>(loaned_array.get().type());
-        std::vector<uint32_t> dimensions;
-        dimensions.resize(array_type.dimension_count());
-        for (uint32_t j = 0; j < array_type.dimension_count(); j++) {
-            dimensions[j] = array_type.dimension(j);
-        }
-
-        ToArrayContext nested_context(1, dimensions);
-        build_document(nested_context, loaned_array.get());
-        context.set_array(nested_context.doc_or_array, member_info);
-    }
-
-    break;
-
-    default:
-        context.set_primitive(data, member_info);
-    }
-
-    ++context.member_index;
-    build_document(context, data);
-}
-
-
 bsoncxx::document::value SampleConverter::to_document(
         const dds::core::xtypes::DynamicData &data)
 {
-    dds::core::xtypes::DynamicData &casted_data =
-            const_cast<dds::core::xtypes::DynamicData &>(data);
-    ToDocumentContext context(data.member_count());
-    build_document(context, casted_data);
-
-    return (context.doc_or_array << builder::stream::finalize);
+    DocumentPlan plan(data.type());
+    return plan.to_document(data);
 }
 
 
@@ -697,8 +213,8 @@ bsoncxx::document::value SampleConverter::to_document(
  * --------------------------------------------------------------------*/
 
 /**
- * @brief Helper obtain the primitive value from a Cursor iterator, either array
- * or document.
+ * @brief Helper to obtain the primitive value from an element, either of an
+ * array or a document.
  *
  * Template specializations are expected to have a single static get() operation
  * to obtain the value
@@ -706,442 +222,726 @@ bsoncxx::document::value SampleConverter::to_document(
  * @tparam Primitive
  *      one of the valid element primitive types. Default behavior assumes the
  * element value is an int32_t.
- * @tparam ItType
- *      Either a document::view::iterator or  array::view::iterator.
+ * @tparam ElementType
+ *      Either a document::element or array::element.
  */
-template<typename Primitive, typename ItType>
-struct cursor_get {
+template<typename Primitive, typename ElementType>
+struct element_get {
     /**
-     * @brief Returns the element value to which the iterator pints.
-     * @param it Iterator positioned to the element whose value is returned
+     * @brief Returns the element value.
+     * @param element Element whose value is returned
      */
-    static Primitive get(ItType it)
+    static Primitive get(const ElementType &element)
     {
-        return static_cast<Primitive>(it->get_int32());
+        return static_cast<Primitive>(element.get_int32());
     }
 };
 
 
-template<typename ItType>
-struct cursor_get<int64_t, ItType> {
+template<typename ElementType>
+struct element_get<int64_t, ElementType> {
+    /**
+     * @brief Returns the value of an element that holds an 64-bit integer.
+     *
+     * @param element Element whose value is returned
+     */
+    static int64_t get(const ElementType &element)
+    {
+        return element.get_int64().value;
+    }
+};
+
+/*
+ * The 32-bit unsigned integers don't fit in a BSON int32, so they are written
+ * as int64.
+ */
+template<typename ElementType>
+struct element_get<uint32_t, ElementType> {
     /**
-     * @brief Returns the value of an element that holds an 64-bit integer from
-     * its positioned iterator.
+     * @brief Returns the value of an element that holds an unsigned 32-bit
+     * integer.
      *
-     * @param it Iterator positioned to the element whose value is returned
+     * @param element Element whose value is returned
      */
-    static int64_t get(ItType it)
+    static uint32_t get(const ElementType &element)
     {
-        return it->get_int64().value;
+        return static_cast<uint32_t>(element.get_int64().value);
     }
 };
 
-template<typename ItType>
-struct cursor_get<std::string, ItType> {
+template<typename ElementType>
+struct element_get<std::string, ElementType> {
     /**
-     * @brief Returns the value of an element that holds a string from its
-     * positioned iterator.
+     * @brief Returns the value of an element that holds a string.
      *
-     * @param it Iterator positioned to the element whose value is returned
+     * @param element Element whose value is returned
      */
-    static std::string get(ItType it)
+    static std::string get(const ElementType &element)
     {
-        return it->get_utf8().value.to_string();
+        return element.get_utf8().value.to_string();
     }
 };
 
-template<typename ItType>
-struct cursor_get<float, ItType> {
+template<typename ElementType>
+struct element_get<float, ElementType> {
     /**
-     * @brief Returns the value of an element that holds a float from its
-     * positioned iterator.
+     * @brief Returns the value of an element that holds a float.
      *
-     * @param it Iterator positioned to the element whose value is returned
+     * @param element Element whose value is returned
      */
-    static float get(ItType it)
+    static float get(const ElementType &element)
     {
-        return static_cast<float>(it->get_double());
+        return static_cast<float>(element.get_double());
     }
 };
 
-template<typename ItType>
-struct cursor_get<double, ItType> {
+template<typename ElementType>
+struct element_get<double, ElementType> {
     /**
-     * @brief Returns the value of an element that holds a double from its
-     * positioned iterator.
+     * @brief Returns the value of an element that holds a double.
      *
-     * @param it Iterator positioned to the element whose value is returned
+     * @param element Element whose value is returned
      */
-    static double get(ItType it)
+    static double get(const ElementType &element)
     {
-        return it->get_double();
+        return element.get_double();
     }
 };
 
-template<typename ItType>
-struct cursor_get<DDS_Boolean, ItType> {
+/*
+ * Keyed on bool rather than DDS_Boolean, which is the same type as uint8_t and
+ * would also read the UINT_8 members as booleans.
+ */
+template<typename ElementType>
+struct element_get<bool, ElementType> {
     /**
-     * @brief Returns the value of an element that holds a bolean from its
-     * positioned iterator.
+     * @brief Returns the value of an element that holds a bolean.
      *
-     * @param it Iterator positioned to the element whose value is returned
+     * @param element Element whose value is returned
      */
-    static DDS_Boolean get(ItType it)
+    static DDS_Boolean get(const ElementType &element)
     {
-        return static_cast<DDS_Boolean>(it->get_bool());
+        return static_cast<DDS_Boolean>(element.get_bool());
+    }
+};
+
+/**
+ * @brief Destination of an element: either a member of a structure or an
+ * element of a collection.
+ *
+ * The elements of a sequence don't exist until they are set, so they can't be
+ * described with DynamicData::member_info(). Instead, they are described once
+ * per collection from the content type.
+ */
+struct MemberDescription {
+    uint32_t index;
+    // Underlying TypeKind values, so the frames holding them stay trivial
+    int32_t kind;
+    // Kind of the elements, when the member is a collection
+    int32_t element_kind;
+
+    /**
+     * @brief Describes a member of a structure.
+     */
+    static MemberDescription from_member_info(
+            const rti::core::xtypes::DynamicDataMemberInfo &member_info)
+    {
+        return MemberDescription { member_info.member_index(),
+                                   member_info.member_kind().underlying(),
+                                   member_info.element_kind().underlying() };
+    }
+
+    /**
+     * @brief Describes the elements of a collection, except for their index.
+     */
+    static MemberDescription from_collection_type(
+            const dds::core::xtypes::DynamicType &type)
+    {
+        using dds::core::xtypes::CollectionType;
+        using rti::core::xtypes::resolve_alias;
+
+        const dds::core::xtypes::DynamicType collection_type =
+                resolve_alias(type);
+        const dds::core::xtypes::DynamicType content_type = resolve_alias(
+                static_cast<const CollectionType &>(collection_type)
+                        .content_type());
+        MemberDescription description { 0,
+                                        content_type.kind().underlying(),
+                                        TypeKind::NO_TYPE };
+        if (content_type.kind() == TypeKind::SEQUENCE_TYPE
+            || content_type.kind() == TypeKind::ARRAY_TYPE) {
+            description.element_kind =
+                    resolve_alias(static_cast<const CollectionType &>(
+                                          content_type)
+                                          .content_type())
+                            .kind()
+                            .underlying();
+        }
+        return description;
     }
 };
 
 /**
  * @brief Helper function to set a primitive member in a DynamicData object,
- * provided a document or array positioned iterator
+ * provided a document or array element
  * @tparam Primitive
  *      Primitive type
- * @tparam ItType
- *      Iterator type (document or array it)
+ * @tparam ElementType
+ *      Element type (document or array element)
  * @param data
  *      Destination DynamicData object
- * @param member_info
- *      Information of the destination member within _data_
- * @param it
- *      Iterator positioned
+ * @param member
+ *      Destination member within _data_
+ * @param element
+ *      Element that holds the value
  */
-template<typename Primitive, typename ItType>
+template<typename Primitive, typename ElementType>
 void from_primitive_element(
         dds::core::xtypes::DynamicData &data,
-        const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-        ItType it)
+        const MemberDescription &member,
+        const ElementType &element)
 {
-    data.value(
-            member_info.member_index(),
-            cursor_get<Primitive, ItType>::get(it));
+    data.value(member.index, element_get<Primitive, ElementType>::get(element));
 }
 
 /**
- * @brief Helper function that selects the proper cursor getter function based
- on the
- * type of the destination DynamicData member
-
- * @tparam ItType
- *      Iterator type (document or array it)
+ * @brief Helper function that selects the proper element getter function based
+ * on the type of the destination DynamicData member
+ *
+ * @tparam ElementType
+ *      Element type (document or array element)
  * @param data
  *      Destination DynamicData object
- * @param member_info
- *      Information of the destination member within _data_
- * @param it
- *      Iterator positioned
+ * @param member
+ *      Destination member within _data_
+ * @param element
+ *      Element that holds the value
  */
-template<typename ItType>
+template<typename ElementType>
 void demultiplex_primitive_element(
         dds::core::xtypes::DynamicData &data,
-        const rti::core::xtypes::DynamicDataMemberInfo &member_info,
-        ItType it)
+        const MemberDescription &member,
+        const ElementType &element)
 {
-    using rti::core::xtypes::DynamicDataMemberInfo;
-
-    typedef std::function<
-            void(DynamicData &, const DynamicDataMemberInfo &, ItType &)>
+    typedef std::function<void(
+            DynamicData &,
+            const MemberDescription &,
+            const ElementType &)>
             FromPrimitiveFunc;
     static std::unordered_map<int32_t, FromPrimitiveFunc> demux_table {
-        { TypeKind::BOOLEAN_TYPE, from_primitive_element<DDS_Boolean, ItType> },
-        { TypeKind::CHAR_8_TYPE, from_primitive_element<DDS_Char, ItType> },
-        { TypeKind::UINT_8_TYPE, from_primitive_element<uint8_t, ItType> },
-        { TypeKind::INT_16_TYPE, from_primitive_element<int16_t, ItType> },
-        { TypeKind::UINT_16_TYPE, from_primitive_element<uint16_t, ItType> },
-        { TypeKind::ENUMERATION_TYPE, from_primitive_element<int32_t, ItType> },
-        { TypeKind::INT_32_TYPE, from_primitive_element<int32_t, ItType> },
-        { TypeKind::INT_64_TYPE, from_primitive_element<int64_t, ItType> },
-        { TypeKind::FLOAT_32_TYPE, from_primitive_element<float, ItType> },
-        { TypeKind::FLOAT_64_TYPE, from_primitive_element<double, ItType> },
-        { TypeKind::STRING_TYPE, from_primitive_element<std::string, ItType> }
+        { TypeKind::BOOLEAN_TYPE,
+          from_primitive_element<bool, ElementType> },
+        { TypeKind::CHAR_8_TYPE,
+          from_primitive_element<DDS_Char, ElementType> },
+        { TypeKind::UINT_8_TYPE, from_primitive_element<uint8_t, ElementType> },
+        { TypeKind::INT_16_TYPE, from_primitive_element<int16_t, ElementType> },
+        { TypeKind::UINT_16_TYPE,
+          from_primitive_element<uint16_t, ElementType> },
+        { TypeKind::ENUMERATION_TYPE,
+          from_primitive_element<int32_t, ElementType> },
+        { TypeKind::INT_32_TYPE, from_primitive_element<int32_t, ElementType> },
+        { TypeKind::UINT_32_TYPE,
+          from_primitive_element<uint32_t, ElementType> },
+        { TypeKind::INT_64_TYPE, from_primitive_element<int64_t, ElementType> },
+        { TypeKind::FLOAT_32_TYPE, from_primitive_element<float, ElementType> },
+        { TypeKind::FLOAT_64_TYPE,
+          from_primitive_element<double, ElementType> },
+        { TypeKind::STRING_TYPE,
+          from_primitive_element<std::string, ElementType> }
 
     };
 
     typename std::unordered_map<int32_t, FromPrimitiveFunc>::iterator table_it =
-            demux_table.find(member_info.member_kind().underlying());
+            demux_table.find(member.kind);
     if (table_it == demux_table.end()) {
         // log unsupported
         std::ostringstream string_stream;
-        string_stream << "unsupported type for member="
-                      << member_info.member_name();
+        string_stream << "unsupported type for member index=" << member.index;
         rti::routing::Logger::instance().debug(string_stream.str());
         return;
     }
 
-    table_it->second(data, member_info, it);
+    table_it->second(data, member, element);
 }
 
-
 /**
- * @brief Helper obtain the associated member info from an array or document
- * element, represnted by a positioned iterator.
+ * @brief Reads the elements of a collection of primitives, either from a BSON
+ * binary with the raw elements or from a BSON array. The nested arrays of a
+ * multi-dimensional array are flattened.
  *
- * Template specializations are expected to have a single static get() operation
- * to obtain the member info
- *
- * @tparam DocOrArray
- *      Either a document::view or  array::view.
+ * @param element
+ *      Element that holds the collection
+ * @param values
+ *      Destination of the elements
  */
-template<typename DocOrArray>
-struct member_info_from_element;
-
-template<>
-struct member_info_from_element<document::view> {
-    /**
-     * @brief Returns the member info for an iterator belonging to a document
-     * element.
-     *
-     * @param data
-     *      associated DynamicData object
-     * @param it
-     *      iterator positioned
-     */
-    rti::core::xtypes::DynamicDataMemberInfo get(
-            dds::core::xtypes::DynamicData &data,
-            document::view::const_iterator &it)
-    {
-        return data.member_info(it->key().to_string());
+template<typename Primitive, typename ElementType>
+void read_primitive_values(
+        const ElementType &element,
+        std::vector<Primitive> &values)
+{
+    if (element.type() == type::k_binary) {
+        types::b_binary binary = element.get_binary();
+        if (binary.size % sizeof(Primitive) != 0) {
+            throw dds::core::InvalidArgumentError(
+                    "binary size is not a multiple of the element size");
+        }
+        values.resize(binary.size / sizeof(Primitive));
+        if (!values.empty()) {
+            std::memcpy(values.data(), binary.bytes, binary.size);
+        }
+        return;
     }
-};
 
-template<>
-struct member_info_from_element<array::view> {
-    /**
-     * @brief Returns the member info for an iterator belonging to an array
-     * element.
-     *
-     * @param data
-     *      associated DynamicData object
-     * @param it
-     *      iterator positioned
-     */
-    rti::core::xtypes::DynamicDataMemberInfo get(
-            dds::core::xtypes::DynamicData &data,
-            array::view::const_iterator &it)
-    {
-        return data.member_info(it->offset());
+    // Iterators of the array and of the nested arrays being read
+    typedef std::pair<array::view::const_iterator, array::view::const_iterator>
+            Range;
+    array::view array = element.get_array().value;
+    std::vector<Range> ranges;
+    ranges.push_back(Range(array.begin(), array.end()));
+    values.clear();
+    while (!ranges.empty()) {
+        Range &range = ranges.back();
+        if (range.first == range.second) {
+            ranges.pop_back();
+            continue;
+        }
+        array::element value = *range.first;
+        ++range.first;
+        if (value.type() == type::k_array) {
+            array::view nested = value.get_array().value;
+            ranges.push_back(Range(nested.begin(), nested.end()));
+            continue;
+        }
+        values.push_back(element_get<Primitive, array::element>::get(value));
     }
-};
+}
+
+template<typename Primitive, typename ElementType>
+void set_primitive_values(
+        dds::core::xtypes::DynamicData &data,
+        const MemberDescription &member,
+        const ElementType &element)
+{
+    std::vector<Primitive> values;
+    read_primitive_values(element, values);
+    data.set_values(member.index, values);
+}
 
 /**
- * @brief Represents of the context used to set a DynamicData element given a
- * Document or Array element.
+ * @brief Sets all the elements of a sequence or array of numeric primitives at
+ * once with set_values(), which avoids loaning the collection and setting each
+ * element on its own.
+ *
+ * @return Whether the collection was set: false if its elements are not
+ * numeric primitives, in which case they have to be set one by one.
  */
-class FromBsonContext {
-public:
-    virtual rti::core::xtypes::DynamicDataMemberInfo member_info(
-            dds::core::xtypes::DynamicData &data) = 0;
-
-    virtual bool end() = 0;
-
-    virtual void operator++() = 0;
-
-    virtual void from_primitive(dds::core::xtypes::DynamicData &data) = 0;
-
-    virtual enum type type() = 0;
-
-    virtual document::view document() = 0;
-
-    virtual array::view array() = 0;
-};
-
-template<typename DocOrArray>
-class FromBsonTypedContext : public FromBsonContext {
-public:
-    FromBsonTypedContext(
-            DocOrArray the_doc_or_array,
-            int32_t the_element_index = 1)
-            : doc_or_array(the_doc_or_array),
-              it(the_doc_or_array.begin()),
-              element_index(the_element_index)
-    {
-    }
-
-    void operator++() override
-    {
-        ++it;
-        ++element_index;
-    }
-
-    bool end() override
-    {
-        return (it == doc_or_array.end());
+template<typename ElementType>
+bool set_primitive_collection(
+        dds::core::xtypes::DynamicData &data,
+        const MemberDescription &member,
+        const ElementType &element)
+{
+    switch (member.element_kind) {
+    case TypeKind::UINT_8_TYPE:
+        set_primitive_values<uint8_t>(data, member, element);
+        return true;
+    case TypeKind::INT_16_TYPE:
+        set_primitive_values<int16_t>(data, member, element);
+        return true;
+    case TypeKind::UINT_16_TYPE:
+        set_primitive_values<uint16_t>(data, member, element);
+        return true;
+    case TypeKind::INT_32_TYPE:
+        set_primitive_values<int32_t>(data, member, element);
+        return true;
+    case TypeKind::UINT_32_TYPE:
+        set_primitive_values<uint32_t>(data, member, element);
+        return true;
+    case TypeKind::INT_64_TYPE:
+        set_primitive_values<int64_t>(data, member, element);
+        return true;
+    case TypeKind::FLOAT_32_TYPE:
+        set_primitive_values<float>(data, member, element);
+        return true;
+    case TypeKind::FLOAT_64_TYPE:
+        set_primitive_values<double>(data, member, element);
+        return true;
+    default:
+        return false;
     }
+}
 
-    void from_primitive(dds::core::xtypes::DynamicData &data) override
-    {
-        demultiplex_primitive_element(data, member_info(data), it);
-    }
+/**
+ * @brief Document or array being converted into a DynamicData complex member.
+ *
+ * Multi-dimensional arrays are nested BSON arrays, whereas DynamicData stores
+ * the elements of all the dimensions in a single flat array. Each nested BSON
+ * array is a frame of its own that sets the elements of the same DynamicData
+ * array, using the element index of the frame of the outermost dimension.
+ */
+struct FromBsonFrame {
+    dds::core::xtypes::DynamicData *data;
+    // Whether data is a loan that must be returned when the frame ends
+    bool loaned;
+    bool is_array;
+    document::view::const_iterator document_it;
+    document::view::const_iterator document_end;
+    array::view::const_iterator array_it;
+    array::view::const_iterator array_end;
+    // Frame with the index of the next element to set, for arrays
+    size_t owner;
+    uint32_t element_index;
+    // Dimensions of a multi-dimensional array still to be flattened
+    uint32_t nested_dimensions;
+    // Description of the elements, for arrays
+    MemberDescription elements;
 
-    enum type type() override
+    bool end() const
     {
-        return it->type();
+        return is_array ? array_it == array_end : document_it == document_end;
     }
+};
 
-    document::view document() override
-    {
-        return it->get_document();
-    }
+/**
+ * @brief Explicit stack of the frames, and of the loans of the complex members
+ * being set.
+ *
+ * A deque never relocates its elements when the stack grows, so the frames can
+ * keep pointers to the loaned members.
+ */
+struct FromBsonStack {
+    std::vector<FromBsonFrame> frames;
+    std::deque<rti::core::xtypes::LoanedDynamicData> loans;
 
-    array::view array() override
+    void push_document(
+            dds::core::xtypes::DynamicData &data,
+            bool loaned,
+            document::view document)
     {
-        return it->get_array();
+        FromBsonFrame frame {};
+        frame.data = &data;
+        frame.loaned = loaned;
+        frame.is_array = false;
+        frame.document_it = document.begin();
+        frame.document_end = document.end();
+        frames.push_back(frame);
     }
 
-    DocOrArray doc_or_array;
-    typename DocOrArray::const_iterator it;
-    int32_t element_index;
-};
-
-class FromDocumentContext : public FromBsonTypedContext<document::view> {
-public:
-    FromDocumentContext(document::view document)
-            : FromBsonTypedContext<document::view>(document)
-    {
+    void push_array(
+            dds::core::xtypes::DynamicData &data,
+            bool loaned,
+            array::view array,
+            size_t owner,
+            uint32_t nested_dimensions,
+            const MemberDescription &elements)
+    {
+        FromBsonFrame frame {};
+        frame.data = &data;
+        frame.loaned = loaned;
+        frame.is_array = true;
+        frame.array_it = array.begin();
+        frame.array_end = array.end();
+        frame.owner = owner;
+        frame.element_index = 1;
+        frame.nested_dimensions = nested_dimensions;
+        frame.elements = elements;
+        frames.push_back(frame);
+    }
+
+    void pop()
+    {
+        if (frames.back().loaned) {
+            loans.pop_back();
+        }
+        frames.pop_back();
     }
 
-    rti::core::xtypes::DynamicDataMemberInfo member_info(
-            dds::core::xtypes::DynamicData &data) override
+    /**
+     * @brief Sets a member from a BSON element. Complex members are loaned and
+     * pushed as a new frame, whose elements are set in the next iterations.
+     */
+    template<typename ElementType>
+    void set_member(
+            dds::core::xtypes::DynamicData &data,
+            const MemberDescription &member,
+            const ElementType &element)
     {
-        return data.member_info(it->key().to_string());
-    }
-};
+        using dds::core::xtypes::ArrayType;
 
-class FromArrayContext : public FromBsonTypedContext<array::view> {
-public:
-    FromArrayContext(array::view array, int32_t the_element_index = 1)
-            : FromBsonTypedContext<array::view>(array, the_element_index),
-              is_new_context(true),
-              finished(false)
-    {
-    }
+        switch (member.kind) {
+        case TypeKind::STRUCTURE_TYPE: {
+            document::view document = element.get_document().value;
+            loans.push_back(data.loan_value(member.index));
+            push_document(loans.back().get(), true, document);
+        } break;
 
-    bool end() override
-    {
-        return FromBsonTypedContext<array::view>::end() || finished;
-    }
+        case TypeKind::SEQUENCE_TYPE:
+        case TypeKind::ARRAY_TYPE: {
+            if (set_primitive_collection(data, member, element)) {
+                break;
+            }
+            array::view array = element.get_array().value;
+            loans.push_back(data.loan_value(member.index));
+            dds::core::xtypes::DynamicData &collection = loans.back().get();
+            uint32_t nested_dimensions = 0;
+            if (member.kind == TypeKind::ARRAY_TYPE) {
+                nested_dimensions = static_cast<const ArrayType &>(
+                                            collection.type())
+                                            .dimension_count()
+                        - 1;
+            }
+            push_array(
+                    collection,
+                    true,
+                    array,
+                    frames.size(),
+                    nested_dimensions,
+                    MemberDescription::from_collection_type(
+                            collection.type()));
+        } break;
 
-    void operator++() override
-    {
-        FromBsonTypedContext<array::view>::operator++();
-        finished = true;
+        default:
+            demultiplex_primitive_element(data, member, element);
+            break;
+        }
     }
 
-    rti::core::xtypes::DynamicDataMemberInfo member_info(
-            dds::core::xtypes::DynamicData &data) override
+    /**
+     * @brief Returns the loans from the innermost member
+     */
+    void clear()
     {
-        return data.member_info(element_index);
+        while (!frames.empty()) {
+            pop();
+        }
     }
-
-    bool is_new_context;
-    bool finished;
 };
 
 /***
  * @brief Builds a DynamicData object from the content of the specified bson
- * object.
- *
- * This is a recursive operation that traverses a bson document/array using DFS
- * approach. It automatically sets the appropriate member based on the type of
- * each element.
+ * document.
  *
- * It is expected that the first call to this operation receives a
- * FromDocumentContext and the top-level DynamicData object. Subsequent
- * operations are self-made to populate the DynamicData object.
+ * The bson document is traversed with a DFS approach, using an explicit stack
+ * of the nested documents and arrays instead of recursion, so the stack depth
+ * doesn't depend on the number of members or elements. The memory used is
+ * proportional to the nesting depth of the document. It automatically sets the
+ * appropriate member based on the type of each element.
  *
+ * A document element that doesn't exist in the DynamicData object, or whose
+ * type doesn't match the member, is logged and skipped.
  *
  * @param[in] data
- *      DynamicData object destination the content for the current element
- * context. In recursive calls, this will be a loaned member.
- * @param[in] context
- *      Current from-element context
+ *      DynamicData object destination of the document content.
+ * @param[in] document
+ *      Source bson document
  */
 void build_dynamic_data(
         dds::core::xtypes::DynamicData &data,
-        FromBsonContext &context)
+        document::view document)
 {
-    using dds::core::xtypes::TypeKind;
-    using rti::core::xtypes::DynamicDataMemberInfo;
-    using rti::core::xtypes::LoanedDynamicData;
-
-    if (context.end()) {
-        return;
-    }
+    FromBsonStack stack;
+    stack.push_document(data, false, document);
 
-    // find a corresponding member/item in dynamic data
     try {
-        // This case occurs when we have a multidimensional array. The bson
-        // document has a nested element structure whereas DynamicData is all
-        // represented in a single multidimensional array. Hence, we need to
-        // create ArrayContext for each array element while using the same
-        // DynamicData loaned array member.
-        if (typeid(context) == typeid(FromArrayContext)) {
-            auto &array_context = dynamic_cast<FromArrayContext &>(context);
-            if (array_context.is_new_context) {
-                array_context.is_new_context = false;
-                // iteratively set each member, to avoid stack overlow on big
-                // sequences/arrays
-                while (!context.end()) {
-                    if (context.type() == type::k_array) {
-                        // need to set an array and start a new context
-                        FromArrayContext nested_context(
-                                context.array(),
-                                array_context.element_index);
-                        build_dynamic_data(data, nested_context);
-                        array_context.element_index =
-                                nested_context.element_index - 1;
-                        ++array_context;
-                    } else {
-                        build_dynamic_data(data, array_context);
-                    }
-                    // reset the context, so it can move to the next available
-                    // item
-                    array_context.finished = false;
-                }
-                // end of processing the array context
-                return;
+        while (!stack.frames.empty()) {
+            FromBsonFrame &frame = stack.frames.back();
+            if (frame.end()) {
+                stack.pop();
+                continue;
             }
-        }
-
-        DynamicDataMemberInfo member_info = context.member_info(data);
-        switch (member_info.member_kind().underlying()) {
-        case TypeKind::STRUCTURE_TYPE: {
-            // need to set a complex member and start a new context
-            LoanedDynamicData loaned_member =
-                    data.loan_value(member_info.member_index());
-            FromDocumentContext nested_context(context.document());
-            build_dynamic_data(loaned_member.get(), nested_context);
-        } break;
 
-        case TypeKind::SEQUENCE_TYPE:
-        case TypeKind::ARRAY_TYPE: {
-            // need to set an array and start a new context
-            LoanedDynamicData loaned_member =
-                    data.loan_value(member_info.member_index());
-            FromArrayContext nested_context(context.array());
-            build_dynamic_data(loaned_member.get(), nested_context);
-        } break;
+            /*
+             * Advance the frame before setting the member, since pushing a
+             * nested frame invalidates the reference to this one.
+             */
+            dds::core::xtypes::DynamicData &current = *frame.data;
+            try {
+                if (!frame.is_array) {
+                    document::element element = *frame.document_it;
+                    ++frame.document_it;
+                    stack.set_member(
+                            current,
+                            MemberDescription::from_member_info(
+                                    current.member_info(
+                                            element.key().to_string())),
+                            element);
+                    continue;
+                }
 
-        default:
-            context.from_primitive(data);
-            break;
+                array::element element = *frame.array_it;
+                ++frame.array_it;
+                if (element.type() == type::k_array
+                    && frame.nested_dimensions > 0) {
+                    // Next dimension of a multi-dimensional array
+                    stack.push_array(
+                            current,
+                            false,
+                            element.get_array().value,
+                            frame.owner,
+                            frame.nested_dimensions - 1,
+                            frame.elements);
+                    continue;
+                }
+                MemberDescription member = frame.elements;
+                member.index = stack.frames[frame.owner].element_index++;
+                stack.set_member(current, member, element);
+            } catch (const std::exception &ex) {
+                // member does not exist / not present
+                rti::routing::Logger::instance().error(
+                        std::string("member mismatch: ")
+                        + std::string(ex.what()));
+            }
         }
-    } catch (const std::exception &ex) {
-        // member does not exist / not present
-        rti::routing::Logger::instance().error(
-                std::string("member mismatch: ") + std::string(ex.what()));
+    } catch (...) {
+        stack.clear();
+        throw;
     }
-
-    // move to the next
-    ++context;
-    build_dynamic_data(data, context);
 }
 
 dds::core::xtypes::DynamicData &SampleConverter::from_document(
         dds::core::xtypes::DynamicData &data,
         const document::view document)
 {
-    FromDocumentContext context(document);
-    build_dynamic_data(data, context);
+    build_dynamic_data(data, document);
     return data;
 }
+
+
+/* --- SampleInfo
+ * --------------------------------------------------------------------*/
+
+/**
+ * @brief Helper to set a member of a native DDS_SampleInfo from a document
+ * element, as written by info_member_setter.
+ *
+ * Template specializations are expected to have a single static get()
+ * operation to perform the conversion.
+ *
+ * @tparam NativeType
+ *      one of the native DDS infrastructure types (e.g., DDS_GUID_t,
+ * DDS_InstanceHandle_t, DDS_Time_t, etc).
+ */
+template<typename NativeType>
+struct info_member_getter;
+
+template<>
+struct info_member_getter<DDS_InstanceHandle_t> {
+    /**
+     * @brief Sets an instance handle from an MD5 binary element.
+     *
+     * @param[in] element
+     *      Element that holds the handle
+     * @param[out] handle
+     *      Destination handle
+     */
+    static void get(
+            const document::element &element,
+            DDS_InstanceHandle_t &handle)
+    {
+        types::b_binary binary = element.get_binary();
+        uint32_t length = std::min<uint32_t>(
+                binary.size,
+                sizeof(handle.keyHash.value));
+        std::memcpy(&handle.keyHash.value[0], binary.bytes, length);
+        handle.keyHash.length = length;
+        handle.isValid = DDS_BOOLEAN_TRUE;
+    }
+};
+
+template<>
+struct info_member_getter<DDS_GUID_t> {
+    /**
+     * @brief Sets a guid from an MD5 binary element.
+     *
+     * @param[in] element
+     *      Element that holds the guid
+     * @param[out] guid
+     *      Destination guid
+     */
+    static void get(const document::element &element, DDS_GUID_t &guid)
+    {
+        types::b_binary binary = element.get_binary();
+        std::memcpy(
+                &guid.value[0],
+                binary.bytes,
+                std::min<size_t>(binary.size, sizeof(guid.value)));
+    }
+};
+
+template<>
+struct info_member_getter<DDS_SequenceNumber_t> {
+    /**
+     * @brief Sets a sequence number from a {high, low} document element.
+     *
+     * @param[in] element
+     *      Element that holds the sequence number
+     * @param[out] sn
+     *      Destination sequence number
+     */
+    static void get(const document::element &element, DDS_SequenceNumber_t &sn)
+    {
+        document::view sn_doc = element.get_document().value;
+        sn.high = sn_doc["high"].get_int32().value;
+        sn.low = static_cast<DDS_UnsignedLong>(sn_doc["low"].get_int64().value);
+    }
+};
+
+template<>
+struct info_member_getter<DDS_Time_t> {
+    /**
+     * @brief Sets a time from a date element, with millisecond resolution.
+     *
+     * @param[in] element
+     *      Element that holds the time
+     * @param[out] time
+     *      Destination time
+     */
+    static void get(const document::element &element, DDS_Time_t &time)
+    {
+        int64_t millis = element.get_date().value.count();
+        time.sec = static_cast<DDS_Long>(millis / 1000);
+        time.nanosec = static_cast<DDS_UnsignedLong>(millis % 1000) * 1000000;
+    }
+};
+
+dds::sub::SampleInfo &SampleConverter::from_document(
+        dds::sub::SampleInfo &info,
+        const document::view document)
+{
+    DDS_SampleInfo native_info = DDS_SAMPLEINFO_DEFAULT;
+    native_info.valid_data = DDS_BOOLEAN_TRUE;
+
+#define SAMPLE_CONVERT_GET_DOC_MEMBER(TYPE, MEMBER)                         \
+    {                                                                       \
+        document::element element = document[#MEMBER];                      \
+        if (element) {                                                      \
+            info_member_getter<TYPE>::get(element, native_info.MEMBER);     \
+        }                                                                   \
+    }
+
+    try {
+        SAMPLE_CONVERT_GET_DOC_MEMBER(DDS_InstanceHandle_t, instance_handle);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(DDS_Time_t, source_timestamp);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(DDS_Time_t, reception_timestamp);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(
+                DDS_GUID_t,
+                original_publication_virtual_guid);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(
+                DDS_SequenceNumber_t,
+                original_publication_virtual_sequence_number);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(
+                DDS_GUID_t,
+                related_original_publication_virtual_guid);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(
+                DDS_SequenceNumber_t,
+                related_original_publication_virtual_sequence_number);
+        SAMPLE_CONVERT_GET_DOC_MEMBER(DDS_GUID_t, topic_query_guid);
+    } catch (const std::exception &ex) {
+        // The members converted so far are kept
+        rti::routing::Logger::instance().error(
+                std::string("info member mismatch: ") + ex.what());
+    }
+
+    info->native() = native_info;
+    return info;
+}
@@ -39,9 +39,13 @@ public:
      * - String -> bsoncxx::utf8
      * - primitive types: A corresponding bson primitive, except:
      *   + uint32_t -> bsoncxx::b_int64
-     *   + enum -> bsoncxx::b_int64
+     *   + enum -> bsoncxx::b_int32
      *
-     * Unions and wide strings are not currently supported.
+     * Unions, wide strings and uint64_t members are not currently supported.
+     *
+     * This operation compiles a DocumentPlan for the type of _data_ on each
+     * call. To convert many samples of the same type, create a DocumentPlan
+     * once and use DocumentPlan::to_document() instead.
      */
     static bsoncxx::document::value to_document(
             const dds::core::xtypes::DynamicData& data);
@@ -69,6 +73,10 @@ public:
      * This operation attempts to set members existing in the input document into
      * members in DynamicData that are present.
      *
+     * Sequences and arrays of numeric primitives are set at once, and can be
+     * either a BSON array or a BSON binary with the raw elements, as written
+     * with the mongo.write.binary_collections property.
+     *
      * @param data destination typed DynamicData
      * @param document input document
      */
@@ -76,6 +84,21 @@ public:
              dds::core::xtypes::DynamicData& data,
              bsoncxx::document::view document);
 
+    /**
+     * @brief Converts a bson Document into a SampleInfo object.
+     *
+     * It's the inverse of the SampleInfo to_document(): the members present
+     * in the document are set, with the times in millisecond resolution. The
+     * rest of the members have their default value, and the info is marked
+     * with valid data.
+     *
+     * @param info destination SampleInfo
+     * @param document input document
+     */
+    static dds::sub::SampleInfo& from_document(
+            dds::sub::SampleInfo& info,
+            bsoncxx::document::view document);
+
 private:
     SampleConverter();
 };
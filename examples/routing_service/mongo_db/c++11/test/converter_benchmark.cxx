@@ -0,0 +1,327 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Benchmark of the conversion between DynamicData samples and BSON documents.
+ *
+ * It doesn't need a MongoDB server: samples of a few type shapes are converted
+ * in memory, and the documents/s of each conversion are reported:
+ *
+ * - wide: a structure with many primitive and string members.
+ * - deep: a chain of nested structures.
+ * - sequences: a structure with a sequence of doubles, a sequence of
+ *   structures and a multi-dimensional array.
+ *
+ * For each shape, to_document is measured both compiling the DocumentPlan on
+ * each call (SampleConverter::to_document) and with a plan compiled once, as
+ * the MongoStreamWriter does. Both directions are also measured with the
+ * collections of numeric primitives stored as BSON binary.
+ *
+ * With --stress, it instead converts a structure with 10000 members and
+ * sequences with 1000000 elements back and forth once, and checks that the
+ * documents before and after the round trip are identical. The conversions
+ * don't recurse per member or element, so they must pass with a small stack
+ * (e.g. ulimit -s 256).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dds/core/xtypes/CollectionTypes.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/PrimitiveTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+
+#include "DocumentPlan.hpp"
+#include "SampleConverter.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::community::examples;
+
+struct BenchmarkOptions {
+    uint32_t iterations = 10000;
+    uint32_t width = 256;
+    uint32_t depth = 16;
+    uint32_t sequence_length = 1024;
+    bool stress = false;
+};
+
+static void print_usage()
+{
+    std::cout << "Usage: converter_benchmark [options]\n"
+              << "    --iterations <n>   Conversions per measure (default "
+                 "10000)\n"
+              << "    --width <n>        Members of the wide type (default "
+                 "256)\n"
+              << "    --depth <n>        Nesting levels of the deep type "
+                 "(default 16)\n"
+              << "    --length <n>       Length of the sequences (default "
+                 "1024)\n"
+              << "    --stress           Round trip of a wide and a long "
+                 "sample\n";
+}
+
+static bool parse_options(int argc, char *argv[], BenchmarkOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--stress") {
+            options.stress = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } catch (const std::exception &) {
+            return false;
+        }
+        if (option == "--iterations") {
+            options.iterations = value;
+        } else if (option == "--width") {
+            options.width = value;
+        } else if (option == "--depth") {
+            options.depth = value;
+        } else if (option == "--length") {
+            options.sequence_length = value;
+        } else {
+            return false;
+        }
+    }
+    return options.iterations > 0 && options.width > 0 && options.depth > 0;
+}
+
+/**
+ * @brief Runs a conversion the given number of times and prints the
+ * documents/s.
+ */
+static void measure(
+        const std::string &name,
+        uint32_t iterations,
+        const std::function<void()> &conversion)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        conversion();
+    }
+    double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    std::cout << "    " << name << ": " << iterations / seconds
+              << " documents/s\n";
+}
+
+static void run_shape(
+        const std::string &shape,
+        const DynamicData &sample,
+        uint32_t iterations)
+{
+    DocumentPlan plan(sample.type());
+    bsoncxx::document::value document = plan.to_document(sample);
+    DocumentPlan binary_plan(sample.type(), true);
+    bsoncxx::document::value binary_document = binary_plan.to_document(sample);
+    DynamicData output(sample.type());
+
+    std::cout << shape << " (" << plan.size() << " instructions, "
+              << document.view().length() << " bytes)\n";
+    measure("to_document, plan per call", iterations, [&sample]() {
+        SampleConverter::to_document(sample);
+    });
+    measure("to_document, compiled plan", iterations, [&plan, &sample]() {
+        plan.to_document(sample);
+    });
+    measure("from_document", iterations, [&output, &document]() {
+        SampleConverter::from_document(output, document.view());
+    });
+    measure("to_document, binary collections",
+            iterations,
+            [&binary_plan, &sample]() { binary_plan.to_document(sample); });
+    measure("from_document, binary collections",
+            iterations,
+            [&output, &binary_document]() {
+                SampleConverter::from_document(
+                        output,
+                        binary_document.view());
+            });
+}
+
+static DynamicData create_wide_sample(uint32_t width)
+{
+    StructType type("Wide");
+    for (uint32_t i = 0; i < width; ++i) {
+        std::string name = "m" + std::to_string(i);
+        switch (i % 3) {
+        case 0:
+            type.add_member(Member(name, primitive_type<int32_t>()));
+            break;
+        case 1:
+            type.add_member(Member(name, primitive_type<double>()));
+            break;
+        default:
+            type.add_member(Member(name, StringType(32)));
+        }
+    }
+
+    DynamicData sample(type);
+    for (uint32_t i = 0; i < width; ++i) {
+        std::string name = "m" + std::to_string(i);
+        switch (i % 3) {
+        case 0:
+            sample.value<int32_t>(name, static_cast<int32_t>(i));
+            break;
+        case 1:
+            sample.value<double>(name, i * 0.5);
+            break;
+        default:
+            sample.value<std::string>(name, "value " + name);
+        }
+    }
+    return sample;
+}
+
+static DynamicData create_deep_sample(uint32_t depth)
+{
+    StructType type("Level" + std::to_string(depth));
+    type.add_member(Member("id", primitive_type<int32_t>()));
+    type.add_member(Member("value", primitive_type<double>()));
+    for (uint32_t level = depth; level > 0; --level) {
+        StructType outer("Level" + std::to_string(level - 1));
+        outer.add_member(Member("id", primitive_type<int32_t>()));
+        outer.add_member(Member("value", primitive_type<double>()));
+        outer.add_member(Member("next", type));
+        type = outer;
+    }
+
+    DynamicData sample(type);
+    sample.value<int32_t>("id", 0);
+    sample.value<double>("value", 0.5);
+    return sample;
+}
+
+static DynamicData create_sequences_sample(uint32_t length)
+{
+    StructType point("Point");
+    point.add_member(Member("x", primitive_type<float>()));
+    point.add_member(Member("y", primitive_type<float>()));
+    point.add_member(Member("z", primitive_type<float>()));
+
+    StructType type("Sequences");
+    type.add_member(Member(
+            "values",
+            SequenceType(primitive_type<double>(), length)));
+    type.add_member(Member("points", SequenceType(point, length)));
+    type.add_member(Member(
+            "matrix",
+            ArrayType(primitive_type<int32_t>(), { 4, 4, 4 })));
+
+    DynamicData sample(type);
+    std::vector<double> values(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        values[i] = i * 0.25;
+    }
+    sample.set_values("values", values);
+
+    DynamicData point_sample(point);
+    {
+        rti::core::xtypes::LoanedDynamicData points =
+                sample.loan_value("points");
+        for (uint32_t i = 0; i < length; ++i) {
+            point_sample.value<float>("x", i * 1.0f);
+            point_sample.value<float>("y", i * 2.0f);
+            point_sample.value<float>("z", i * 3.0f);
+            points.get().value(i + 1, point_sample);
+        }
+    }
+    return sample;
+}
+
+/**
+ * @brief Converts a sample into a document and back, and checks that the
+ * documents before and after the round trip are identical.
+ */
+static bool round_trip(const std::string &shape, const DynamicData &sample)
+{
+    auto start = std::chrono::steady_clock::now();
+    bsoncxx::document::value document = SampleConverter::to_document(sample);
+    DynamicData output(sample.type());
+    SampleConverter::from_document(output, document.view());
+    bsoncxx::document::value round_trip_document =
+            SampleConverter::to_document(output);
+    double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    bool equal = document.view().length()
+                    == round_trip_document.view().length()
+            && std::memcmp(
+                       document.view().data(),
+                       round_trip_document.view().data(),
+                       document.view().length())
+                    == 0;
+    std::cout << shape << " (" << document.view().length()
+              << " bytes): " << (equal ? "OK" : "MISMATCH") << ", "
+              << seconds << " s\n";
+    return equal;
+}
+
+static bool run_stress()
+{
+    bool passed = round_trip(
+            "wide, 10000 members",
+            create_wide_sample(10000));
+    passed = round_trip(
+                     "sequences, 1000000 elements",
+                     create_sequences_sample(1000000))
+            && passed;
+    return passed;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        if (options.stress) {
+            return run_stress() ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        run_shape(
+                "wide, " + std::to_string(options.width) + " members",
+                create_wide_sample(options.width),
+                options.iterations);
+        run_shape(
+                "deep, " + std::to_string(options.depth) + " levels",
+                create_deep_sample(options.depth),
+                options.iterations);
+        run_shape(
+                "sequences, " + std::to_string(options.sequence_length)
+                        + " elements",
+                create_sequences_sample(options.sequence_length),
+                std::max<uint32_t>(options.iterations / 100, 1));
+    } catch (const std::exception &ex) {
+        std::cerr << "error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,410 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Randomized round trip of the conversion between DynamicData samples and
+ * BSON documents.
+ *
+ * It doesn't need a MongoDB server: it generates random structure types, with
+ * all the primitive types supported by the DocumentPlan, strings, enums,
+ * nested and optional members, sequences, multi-dimensional arrays and
+ * sequences of sequences. Then it fills samples of each type with random
+ * values, converts them into documents and back, both with BSON arrays and
+ * with the collections of numeric primitives stored as BSON binary, and
+ * checks that the samples before and after the round trip are equal.
+ *
+ * The types and values only depend on the seed, so a failure can be
+ * reproduced with the same options. For each type, the documents/s of each
+ * direction are reported.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/json.hpp>
+#include <dds/core/xtypes/CollectionTypes.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/EnumType.hpp>
+#include <dds/core/xtypes/PrimitiveTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+
+#include "DocumentPlan.hpp"
+#include "SampleConverter.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::community::examples;
+
+struct FuzzOptions {
+    uint32_t seed = 1;
+    uint32_t types = 100;
+    uint32_t samples = 100;
+    uint32_t max_depth = 3;
+};
+
+static void print_usage()
+{
+    std::cout << "Usage: converter_fuzz [options]\n"
+              << "    --seed <n>         Seed of the random types and values "
+                 "(default 1)\n"
+              << "    --types <n>        Random types to generate (default "
+                 "100)\n"
+              << "    --samples <n>      Random samples of each type "
+                 "(default 100)\n"
+              << "    --max-depth <n>    Nesting levels of the types "
+                 "(default 3)\n";
+}
+
+static bool parse_options(int argc, char *argv[], FuzzOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } catch (const std::exception &) {
+            return false;
+        }
+        if (option == "--seed") {
+            options.seed = value;
+        } else if (option == "--types") {
+            options.types = value;
+        } else if (option == "--samples") {
+            options.samples = value;
+        } else if (option == "--max-depth") {
+            options.max_depth = value;
+        } else {
+            return false;
+        }
+    }
+    return options.types > 0 && options.samples > 0;
+}
+
+/**
+ * @brief Generates random types, and random samples of them.
+ */
+class RandomGenerator {
+public:
+    explicit RandomGenerator(uint32_t seed) : engine_(seed), type_count_(0)
+    {
+    }
+
+    /**
+     * @brief Returns a random structure with up to max_depth levels of nested
+     * structures and collections.
+     */
+    StructType create_struct(uint32_t max_depth)
+    {
+        StructType type("Fuzz" + std::to_string(type_count_++));
+        uint32_t member_count = uniform(1, 8);
+        for (uint32_t i = 0; i < member_count; ++i) {
+            Member member("m" + std::to_string(i), create_type(max_depth));
+            if (uniform(0, 4) == 0) {
+                member.optional(true);
+            }
+            type.add_member(member);
+        }
+        return type;
+    }
+
+    /**
+     * @brief Sets random values to all the members of a structure, leaving
+     * some of the optional members unset.
+     */
+    void fill_struct(DynamicData &data)
+    {
+        const StructType &type = static_cast<const StructType &>(data.type());
+        for (uint32_t i = 0; i < type.member_count(); ++i) {
+            const Member &member = type.member(i);
+            if (member.is_optional() && uniform(0, 1) == 0) {
+                continue;
+            }
+            fill_value(data, i + 1, member.type());
+        }
+    }
+
+private:
+    DynamicType create_type(uint32_t max_depth)
+    {
+        uint32_t choice = uniform(0, max_depth > 0 ? 16 : 12);
+        switch (choice) {
+        case 0:
+            return primitive_type<bool>();
+        case 1:
+            return primitive_type<DDS_Char>();
+        case 2:
+            return primitive_type<uint8_t>();
+        case 3:
+            return primitive_type<int16_t>();
+        case 4:
+            return primitive_type<uint16_t>();
+        case 5:
+            return primitive_type<int32_t>();
+        case 6:
+            return primitive_type<uint32_t>();
+        case 7:
+            return primitive_type<int64_t>();
+        case 8:
+            return primitive_type<float>();
+        case 9:
+            return primitive_type<double>();
+        case 10:
+            return StringType(uniform(1, 32));
+        case 11:
+        case 12:
+            return create_enum();
+        case 13:
+            return create_struct(max_depth - 1);
+        case 14:
+            return SequenceType(create_type(max_depth - 1), uniform(1, 32));
+        case 15: {
+            std::vector<uint32_t> dimensions(uniform(1, 3));
+            for (uint32_t &dimension : dimensions) {
+                dimension = uniform(1, 4);
+            }
+            return ArrayType(create_type(max_depth - 1), dimensions);
+        }
+        default:
+            // Sequence of sequences
+            return SequenceType(
+                    SequenceType(create_type(0), uniform(1, 8)),
+                    uniform(1, 8));
+        }
+    }
+
+    EnumType create_enum()
+    {
+        std::vector<EnumMember> members;
+        uint32_t member_count = uniform(1, 5);
+        for (uint32_t i = 0; i < member_count; ++i) {
+            members.push_back(EnumMember(
+                    "E" + std::to_string(type_count_) + "_"
+                            + std::to_string(i),
+                    static_cast<int32_t>(i * 3)));
+        }
+        return EnumType("FuzzEnum" + std::to_string(type_count_++), members);
+    }
+
+    /**
+     * @brief Sets a random value to the member or element with the given
+     * index.
+     */
+    void fill_value(DynamicData &data, uint32_t index, const DynamicType &type)
+    {
+        const DynamicType resolved_type =
+                rti::core::xtypes::resolve_alias(type);
+        switch (resolved_type.kind().underlying()) {
+        case TypeKind::BOOLEAN_TYPE:
+            data.value<DDS_Boolean>(
+                    index,
+                    static_cast<DDS_Boolean>(uniform(0, 1)));
+            break;
+        case TypeKind::CHAR_8_TYPE:
+            data.value<DDS_Char>(
+                    index,
+                    static_cast<DDS_Char>(uniform(32, 126)));
+            break;
+        case TypeKind::UINT_8_TYPE:
+            data.value<uint8_t>(index, random_integer<uint8_t>());
+            break;
+        case TypeKind::INT_16_TYPE:
+            data.value<int16_t>(index, random_integer<int16_t>());
+            break;
+        case TypeKind::UINT_16_TYPE:
+            data.value<uint16_t>(index, random_integer<uint16_t>());
+            break;
+        case TypeKind::INT_32_TYPE:
+            data.value<int32_t>(index, random_integer<int32_t>());
+            break;
+        case TypeKind::UINT_32_TYPE:
+            data.value<uint32_t>(index, random_integer<uint32_t>());
+            break;
+        case TypeKind::INT_64_TYPE:
+            data.value<int64_t>(index, random_integer<int64_t>());
+            break;
+        case TypeKind::FLOAT_32_TYPE:
+            data.value<float>(
+                    index,
+                    std::uniform_real_distribution<float>(-1e6f, 1e6f)(
+                            engine_));
+            break;
+        case TypeKind::FLOAT_64_TYPE:
+            data.value<double>(
+                    index,
+                    std::uniform_real_distribution<double>(-1e12, 1e12)(
+                            engine_));
+            break;
+        case TypeKind::STRING_TYPE: {
+            std::string value(
+                    uniform(0, static_cast<const StringType &>(resolved_type)
+                                       .bounds()),
+                    ' ');
+            for (char &c : value) {
+                c = static_cast<char>(uniform(32, 126));
+            }
+            data.value<std::string>(index, value);
+        } break;
+        case TypeKind::ENUMERATION_TYPE: {
+            const EnumType &enum_type =
+                    static_cast<const EnumType &>(resolved_type);
+            data.value<int32_t>(
+                    index,
+                    enum_type.member(uniform(0, enum_type.member_count() - 1))
+                            .ordinal());
+        } break;
+
+        case TypeKind::STRUCTURE_TYPE: {
+            rti::core::xtypes::LoanedDynamicData loan = data.loan_value(index);
+            fill_struct(loan.get());
+        } break;
+
+        case TypeKind::SEQUENCE_TYPE: {
+            const SequenceType &sequence_type =
+                    static_cast<const SequenceType &>(resolved_type);
+            rti::core::xtypes::LoanedDynamicData loan = data.loan_value(index);
+            uint32_t length = uniform(0, sequence_type.bounds());
+            for (uint32_t i = 1; i <= length; ++i) {
+                fill_value(loan.get(), i, sequence_type.content_type());
+            }
+        } break;
+
+        case TypeKind::ARRAY_TYPE: {
+            const ArrayType &array_type =
+                    static_cast<const ArrayType &>(resolved_type);
+            rti::core::xtypes::LoanedDynamicData loan = data.loan_value(index);
+            for (uint32_t i = 1; i <= array_type.total_element_count(); ++i) {
+                fill_value(loan.get(), i, array_type.content_type());
+            }
+        } break;
+
+        default:
+            throw dds::core::InvalidArgumentError(
+                    "unexpected type " + resolved_type.name());
+        }
+    }
+
+    template<typename Integer>
+    Integer random_integer()
+    {
+        return static_cast<Integer>(std::uniform_int_distribution<int64_t>(
+                static_cast<int64_t>(std::numeric_limits<Integer>::min()),
+                static_cast<int64_t>(std::numeric_limits<Integer>::max()))(
+                engine_));
+    }
+
+    uint32_t uniform(uint32_t min, uint32_t max)
+    {
+        return std::uniform_int_distribution<uint32_t>(min, max)(engine_);
+    }
+
+    std::mt19937 engine_;
+    uint32_t type_count_;
+};
+
+/**
+ * @brief Converts the samples into documents with the given plan and back,
+ * and checks that they are equal. Prints the documents/s of each direction.
+ */
+static bool round_trip(
+        const std::string &name,
+        const StructType &type,
+        const std::vector<DynamicData> &samples,
+        DocumentPlan &plan)
+{
+    std::vector<bsoncxx::document::value> documents;
+    documents.reserve(samples.size());
+    std::vector<DynamicData> outputs(samples.size(), DynamicData(type));
+
+    auto start = std::chrono::steady_clock::now();
+    for (const DynamicData &sample : samples) {
+        documents.push_back(plan.to_document(sample));
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); ++i) {
+        SampleConverter::from_document(outputs[i], documents[i].view());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (!(outputs[i] == samples[i])) {
+            std::cout << "    " << name << ": MISMATCH in sample " << i
+                      << "\n    document: "
+                      << bsoncxx::to_json(documents[i].view())
+                      << "\n    round trip: "
+                      << bsoncxx::to_json(
+                                 plan.to_document(outputs[i]).view())
+                      << "\n";
+            return false;
+        }
+    }
+
+    std::cout << "    " << name << ": to_document "
+              << samples.size()
+                    / std::chrono::duration<double>(middle - start).count()
+              << " documents/s, from_document "
+              << samples.size()
+                    / std::chrono::duration<double>(end - middle).count()
+              << " documents/s\n";
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    FuzzOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    uint32_t failures = 0;
+    try {
+        RandomGenerator generator(options.seed);
+        for (uint32_t t = 0; t < options.types; ++t) {
+            StructType type = generator.create_struct(options.max_depth);
+            std::vector<DynamicData> samples;
+            samples.reserve(options.samples);
+            for (uint32_t i = 0; i < options.samples; ++i) {
+                samples.push_back(DynamicData(type));
+                generator.fill_struct(samples.back());
+            }
+
+            DocumentPlan plan(type);
+            DocumentPlan binary_plan(type, true);
+            std::cout << "type " << t << " (" << type.member_count()
+                      << " members, " << plan.size() << " instructions)\n";
+            bool passed = round_trip("arrays", type, samples, plan);
+            passed = round_trip(
+                             "binary collections",
+                             type,
+                             samples,
+                             binary_plan)
+                    && passed;
+            if (!passed) {
+                ++failures;
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << options.types - failures << " of " << options.types
+              << " types passed (seed " << options.seed << ")\n";
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
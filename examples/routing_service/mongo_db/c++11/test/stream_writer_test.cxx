@@ -0,0 +1,255 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Test of the batched insertions of the MongoStreamWriter against a MongoDB
+ * server, e.g. a local mongod, given with mongo.uri.
+ *
+ * Shapes are written in write() calls that don't complete a batch, with a
+ * linger time. The test checks that:
+ *
+ * - write() inserts the complete batches before returning,
+ * - the linger thread inserts the remaining documents after the linger time,
+ * - deleting the StreamWriter doesn't insert any document twice,
+ *
+ * and that every shape is read back once with its values. The collection is
+ * dropped before and after the test.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <mongocxx/instance.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/PrimitiveTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+
+#include "MongoConfig.hpp"
+#include "MongoConnection.hpp"
+#include "MongoStreamWriter.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::community::examples;
+
+struct TestOptions {
+    std::string uri = "mongodb://localhost:27017";
+    std::string db_name = "dds_test";
+    int32_t count = 250;
+    int32_t batch_size = 100;
+    int32_t linger_ms = 500;
+};
+
+static const std::string COLLECTION_NAME = "StreamWriterTest";
+// Samples per write(), so the last batch is completed by the linger thread
+static const int32_t SAMPLES_PER_WRITE = 7;
+
+static void print_usage()
+{
+    std::cout << "Usage: stream_writer_test [options]\n"
+              << "    --uri <uri>        MongoDB URI (default "
+                 "mongodb://localhost:27017)\n"
+              << "    --db <name>        Database (default dds_test)\n"
+              << "    --count <n>        Samples to write (default 250)\n"
+              << "    --batch <n>        Batch size (default 100)\n"
+              << "    --linger <ms>      Linger time (default 500)\n";
+}
+
+static bool parse_options(int argc, char *argv[], TestOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (option == "--uri") {
+                options.uri = value;
+            } else if (option == "--db") {
+                options.db_name = value;
+            } else if (option == "--count") {
+                options.count = std::stoi(value);
+            } else if (option == "--batch") {
+                options.batch_size = std::stoi(value);
+            } else if (option == "--linger") {
+                options.linger_ms = std::stoi(value);
+            } else {
+                return false;
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    return options.count > 0 && options.batch_size > 0
+            && options.linger_ms > 0;
+}
+
+static StructType create_shape_type()
+{
+    StructType type("ShapeType");
+    type.add_member(Member("color", StringType(128)).key(true));
+    type.add_member(Member("x", primitive_type<int32_t>()));
+    type.add_member(Member("y", primitive_type<int32_t>()));
+    type.add_member(Member("shapesize", primitive_type<int32_t>()));
+    return type;
+}
+
+static int64_t count_documents(MongoConnection &connection)
+{
+    auto client = connection.client();
+    return client->database(connection.db_name())[COLLECTION_NAME]
+            .count_documents({});
+}
+
+static void drop_collection(MongoConnection &connection)
+{
+    auto client = connection.client();
+    client->database(connection.db_name())[COLLECTION_NAME].drop();
+}
+
+static void check(bool condition, const std::string &message)
+{
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+/**
+ * Reads the shapes back and checks that each one was inserted once with the
+ * values it was written with.
+ */
+static void check_documents(
+        MongoConnection &connection,
+        const TestOptions &options)
+{
+    std::vector<int32_t> found(options.count, 0);
+    auto client = connection.client();
+    mongocxx::collection collection =
+            client->database(connection.db_name())[COLLECTION_NAME];
+    for (bsoncxx::document::view document : collection.find({})) {
+        bsoncxx::document::view data = document["data"].get_document().value;
+        int32_t x = data["x"].get_int32().value;
+        check(x >= 0 && x < options.count,
+              "unexpected x=" + std::to_string(x));
+        check(data["y"].get_int32().value == 2 * x,
+              "unexpected y of x=" + std::to_string(x));
+        check(data["color"].get_utf8().value.to_string() == "BLUE",
+              "unexpected color of x=" + std::to_string(x));
+        ++found[x];
+    }
+    for (int32_t x = 0; x < options.count; ++x) {
+        check(found[x] == 1,
+              "x=" + std::to_string(x) + " inserted "
+                      + std::to_string(found[x]) + " times");
+    }
+}
+
+static void run_test(const TestOptions &options)
+{
+    rti::routing::PropertySet connection_properties;
+    connection_properties[MongoConfig::name<MongoConfig::URI>()] = options.uri;
+    connection_properties[MongoConfig::name<MongoConfig::DB_NAME>()] =
+            options.db_name;
+    MongoConnection connection(connection_properties);
+    drop_collection(connection);
+
+    StructType type = create_shape_type();
+    rti::routing::StreamInfo info(COLLECTION_NAME, type.name());
+    info.type_info().type_representation_kind(
+            rti::routing::TypeRepresentationKind::DYNAMIC_TYPE);
+    info.type_info().type_representation(&type.native());
+
+    rti::routing::PropertySet properties;
+    properties[MongoConfig::name<MongoConfig::WRITE_BATCH_SIZE>()] =
+            std::to_string(options.batch_size);
+    properties[MongoConfig::name<MongoConfig::WRITE_LINGER_MS>()] =
+            std::to_string(options.linger_ms);
+    std::unique_ptr<MongoStreamWriter> writer(
+            new MongoStreamWriter(connection, info, properties));
+
+    std::vector<DynamicData> samples;
+    for (int32_t x = 0; x < options.count; ++x) {
+        DynamicData sample(type);
+        sample.value<std::string>("color", "BLUE");
+        sample.value("x", x);
+        sample.value("y", 2 * x);
+        sample.value("shapesize", 30);
+        samples.push_back(sample);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t first = 0; first < options.count;
+         first += SAMPLES_PER_WRITE) {
+        std::vector<DynamicData *> write_samples;
+        for (int32_t x = first;
+             x < options.count && x < first + SAMPLES_PER_WRITE;
+             ++x) {
+            write_samples.push_back(&samples[x]);
+        }
+        std::vector<dds::sub::SampleInfo *> infos(write_samples.size(), NULL);
+        writer->write(write_samples, infos);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Without workers, the complete batches are inserted by write()
+    int64_t batched_count =
+            options.count / options.batch_size * options.batch_size;
+    int64_t inserted = count_documents(connection);
+    check(inserted >= batched_count,
+          "write() inserted " + std::to_string(inserted)
+                  + " documents, expected at least "
+                  + std::to_string(batched_count));
+    if (elapsed < std::chrono::milliseconds(options.linger_ms)) {
+        check(inserted == batched_count,
+              "inserted " + std::to_string(inserted)
+                      + " documents before the linger time, expected "
+                      + std::to_string(batched_count));
+    }
+
+    std::this_thread::sleep_for(
+            std::chrono::milliseconds(2 * options.linger_ms + 500));
+    inserted = count_documents(connection);
+    check(inserted == options.count,
+          "the linger thread inserted " + std::to_string(inserted)
+                  + " documents, expected " + std::to_string(options.count));
+
+    writer.reset();
+    check_documents(connection, options);
+    drop_collection(connection);
+}
+
+int main(int argc, char *argv[])
+{
+    TestOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    mongocxx::instance instance {};
+    try {
+        run_test(options);
+    } catch (const std::exception &ex) {
+        std::cerr << "Test failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Test passed: " << options.count << " documents inserted "
+              << "in batches of " << options.batch_size << " with "
+              << options.linger_ms << " ms of linger" << std::endl;
+    return 0;
+}
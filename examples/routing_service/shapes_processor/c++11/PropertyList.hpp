@@ -0,0 +1,43 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef PROPERTY_LIST_HPP_
+#define PROPERTY_LIST_HPP_
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Splits the value of a list property by a separator, ignoring the
+ * blanks around each token. Empty tokens are kept, so the callers decide
+ * whether they're valid.
+ */
+inline std::vector<std::string> split_property_list(
+        const std::string &value,
+        char separator)
+{
+    std::vector<std::string> tokens;
+    std::istringstream stream(value);
+    std::string token;
+    while (std::getline(stream, token, separator)) {
+        size_t begin = token.find_first_not_of(" \t\n");
+        size_t end = token.find_last_not_of(" \t\n");
+        tokens.push_back(
+                begin == std::string::npos
+                        ? std::string()
+                        : token.substr(begin, end - begin + 1));
+    }
+    return tokens;
+}
+
+#endif
@@ -52,22 +52,32 @@ void ShapesAggregator::on_output_enabled(
 
 void ShapesAggregator::on_data_available(rti::routing::processor::Route &route)
 {
-    // Use squares as 'leading' input. For each Square instance, get the
-    // equivalent instance from the Circle topic
-    auto squares = route.input<DynamicData>("Square").read();
+    // Keep the latest size of each Circle instance, taking only the new
+    // samples
+    auto circles = route.input<DynamicData>("Circle").take();
+    for (auto circle_sample : circles) {
+        if (circle_sample.info().valid()) {
+            circle_sizes_[circle_sample.info().instance_handle()] =
+                    circle_sample.data().value<int32_t>("y");
+        } else if (
+                circle_sample.info().state().instance_state()
+                != InstanceState::alive()) {
+            circle_sizes_.erase(circle_sample.info().instance_handle());
+        }
+    }
+
+    // Use squares as 'leading' input. For each new Square sample, get the
+    // size of the equivalent instance from the Circle topic
+    auto squares = route.input<DynamicData>("Square").take();
     for (auto square_sample : squares) {
         if (square_sample.info().valid()) {
             output_data_ = square_sample.data();
-            // read equivalent existing instance in the Circles stream
-            auto circles =
-                    route.input<DynamicData>("Circle")
-                            .select()
-                            .instance(square_sample.info().instance_handle())
-                            .read();
-            if (circles.length() != 0 && circles[0].info().valid()) {
+            auto circle_size = circle_sizes_.find(
+                    square_sample.info().instance_handle());
+            if (circle_size != circle_sizes_.end()) {
                 output_data_.get().value<int32_t>(
                         "shapesize",
-                        circles[0].data().value<int32_t>("y"));
+                        circle_size->second);
             }
             // Write aggregated sample intro Triangles
             route.output<DynamicData>("Triangle").write(output_data_.get());
@@ -75,11 +85,6 @@ void ShapesAggregator::on_data_available(rti::routing::processor::Route &route)
             // propagate the dispose
             route.output<DynamicData>("Triangle")
                     .write(output_data_.get(), square_sample.info());
-            // clear instance instance
-            route.input<DynamicData>("Square")
-                    .select()
-                    .instance(square_sample.info().instance_handle())
-                    .take();
         }
     }
 }
@@ -16,15 +16,34 @@
 #include <iterator>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unordered_map>
 
 #include <dds/core/corefwd.hpp>
 
+#include <dds/core/InstanceHandle.hpp>
 #include <dds/core/Optional.hpp>
 #include <dds/core/xtypes/DynamicData.hpp>
 #include <dds/core/xtypes/StructType.hpp>
 #include <rti/routing/processor/Processor.hpp>
 #include <rti/routing/processor/ProcessorPlugin.hpp>
 
+/**
+ * Hash of an InstanceHandle, so it can be the key of an unordered_map. The
+ * handles of the instances with the same key value are the same on every
+ * Topic of the type, since they are computed from the key hash.
+ */
+struct InstanceHandleHash {
+    size_t operator()(const dds::core::InstanceHandle &handle) const
+    {
+        const DDS_KeyHash_t &key_hash = handle->native().keyHash;
+        size_t hash = 0;
+        for (unsigned int i = 0; i < sizeof(key_hash.value); ++i) {
+            hash = hash * 31 + key_hash.value[i];
+        }
+        return hash;
+    }
+};
+
 class ShapesAggregator : public rti::routing::processor::NoOpProcessor {
 public:
     void on_data_available(rti::routing::processor::Route &);
@@ -42,6 +61,10 @@ private:
     // only when the output is enabled.
     // You can use std::optional if supported in your platform
     dds::core::optional<dds::core::xtypes::DynamicData> output_data_;
+    // Latest y of each Circle instance, which becomes the size of the
+    // Triangle of the same instance
+    std::unordered_map<dds::core::InstanceHandle, int32_t, InstanceHandleHash>
+            circle_sizes_;
 };
 
 
@@ -15,12 +15,14 @@
 
 #include <dds/core/corefwd.hpp>
 
+#include <dds/core/Exception.hpp>
 #include <dds/core/xtypes/DynamicData.hpp>
 #include <dds/core/xtypes/StructType.hpp>
 #include <rti/routing/Logger.hpp>
 #include <rti/routing/processor/Processor.hpp>
 #include <rti/routing/processor/ProcessorPlugin.hpp>
 
+#include "PropertyList.hpp"
 #include "ShapesSplitter.hpp"
 
 using namespace rti::routing;
@@ -30,12 +32,49 @@ using namespace dds::core::xtypes;
 using namespace dds::sub::status;
 
 
+const std::string ShapesSplitterProperty::MODE = "splitter.mode";
+const std::string ShapesSplitterProperty::CLEARED_MEMBERS =
+        "splitter.cleared_members";
+
 /*
  * --- ShapesSplitter ---------------------------------------------------------
  */
 
-ShapesSplitter::ShapesSplitter()
+ShapesSplitter::ShapesSplitter(const rti::routing::PropertySet &properties)
+        : member_mask_(false)
 {
+    rti::routing::PropertySet::const_iterator it =
+            properties.find(ShapesSplitterProperty::MODE);
+    if (it != properties.end() && it->second != "copy") {
+        if (it->second != "member_mask") {
+            throw dds::core::InvalidArgumentError(
+                    "invalid value for property "
+                    + ShapesSplitterProperty::MODE + ": " + it->second);
+        }
+        member_mask_ = true;
+    }
+
+    // By default, the first output has y = 0 and the second one x = 0
+    it = properties.find(ShapesSplitterProperty::CLEARED_MEMBERS);
+    std::string cleared_members = it != properties.end() ? it->second : "y;x";
+    // An empty list (e.g. the second one in "y;;x") is an output that gets
+    // every member
+    for (const std::string &output_members :
+         split_property_list(cleared_members, ';')) {
+        std::vector<std::string> members;
+        for (const std::string &member :
+             split_property_list(output_members, ',')) {
+            if (!member.empty()) {
+                members.push_back(member);
+            }
+        }
+        cleared_members_.push_back(members);
+    }
+    if (cleared_members_.empty()) {
+        throw dds::core::InvalidArgumentError(
+                "property " + ShapesSplitterProperty::CLEARED_MEMBERS
+                + " must define at least one output");
+    }
 }
 
 ShapesSplitter::~ShapesSplitter()
@@ -50,6 +89,10 @@ void ShapesSplitter::on_input_enabled(
     // be the type the input as well as the two outputs. Hence we can use
     // the input type to initialize the output data buffer
     output_data_ = input.get<DynamicData>().create_data();
+    if (member_mask_) {
+        split_plan_.reset(
+                new SplitPlan(output_data_.get().type(), cleared_members_));
+    }
 }
 
 void ShapesSplitter::on_data_available(rti::routing::processor::Route &route)
@@ -57,25 +100,34 @@ void ShapesSplitter::on_data_available(rti::routing::processor::Route &route)
     // Split input shapes  into mono-dimensional output shapes
     auto input_samples = route.input<DynamicData>(0).take();
     for (auto sample : input_samples) {
-        if (sample.info().valid()) {
-            // split into first output
-            output_data_ = sample.data();
-            output_data_.get().value<int32_t>("y", 0);
-            route.output<DynamicData>(0).write(
-                    output_data_.get(),
-                    sample.info());
-            // split into second output
-            output_data_ = sample.data();
-            output_data_.get().value<int32_t>("x", 0);
-            route.output<DynamicData>(1).write(
-                    output_data_.get(),
-                    sample.info());
-        } else {
+        if (!sample.info().valid()) {
             // propagate dispose
-            route.output<DynamicData>(0).write(
-                    output_data_.get(),
-                    sample.info());
-            route.output<DynamicData>(1).write(
+            for (size_t i = 0; i < cleared_members_.size(); ++i) {
+                route.output<DynamicData>(i).write(
+                        output_data_.get(),
+                        sample.info());
+            }
+            continue;
+        }
+
+        if (split_plan_) {
+            // copy the members of the sample into the outputs at once
+            split_plan_->split(sample.data());
+            for (size_t i = 0; i < split_plan_->output_count(); ++i) {
+                route.output<DynamicData>(i).write(
+                        split_plan_->output(i),
+                        sample.info());
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < cleared_members_.size(); ++i) {
+            // split into the i-th output
+            output_data_ = sample.data();
+            for (const std::string &member : cleared_members_[i]) {
+                output_data_.get().clear_member(member);
+            }
+            route.output<DynamicData>(i).write(
                     output_data_.get(),
                     sample.info());
         }
@@ -97,7 +149,7 @@ rti::routing::processor::Processor *ShapesSplitterPlugin::create_processor(
         const rti::routing::PropertySet &properties)
 {
     rti::routing::Logger::instance().local("ShapesSplitter Processor created");
-    return new ShapesSplitter();
+    return new ShapesSplitter(properties);
 }
 
 void ShapesSplitterPlugin::delete_processor(
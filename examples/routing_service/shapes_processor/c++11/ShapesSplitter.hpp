@@ -14,8 +14,11 @@
 #define SHAPES_PROCESSOR_HPP_
 
 #include <iterator>
+#include <memory>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string>
+#include <vector>
 
 #include <dds/core/corefwd.hpp>
 
@@ -25,6 +28,23 @@
 #include <rti/routing/processor/Processor.hpp>
 #include <rti/routing/processor/ProcessorPlugin.hpp>
 
+#include "SplitPlan.hpp"
+
+/**
+ * Names of the properties of the ShapesSplitter processor.
+ */
+struct ShapesSplitterProperty {
+    // How the output samples are created. Default: copy
+    // - copy: the input sample is assigned to the output sample, and then the
+    //   cleared members are reset.
+    // - member_mask: the members of the input sample are copied only into the
+    //   reused samples of the outputs they aren't cleared from (see SplitPlan).
+    static const std::string MODE;
+    // Semicolon-separated lists, one per output in order, of the
+    // comma-separated members left to zero in each output. Default: y;x
+    static const std::string CLEARED_MEMBERS;
+};
+
 class ShapesSplitter : public rti::routing::processor::NoOpProcessor {
 public:
     void on_data_available(rti::routing::processor::Route &) override;
@@ -33,11 +53,16 @@ public:
             rti::routing::processor::Route &route,
             rti::routing::processor::Input &input) override;
 
-    ShapesSplitter();
+    ShapesSplitter(const rti::routing::PropertySet &properties);
 
     ~ShapesSplitter();
 
 private:
+    bool member_mask_;
+    std::vector<std::vector<std::string>> cleared_members_;
+    // Created when the input is enabled, in member_mask mode
+    std::unique_ptr<SplitPlan> split_plan_;
+
     // Optional member for deferred initialization: this object can be created
     // only when the output is enabled.
     // You can use std::optional if supported in your platform
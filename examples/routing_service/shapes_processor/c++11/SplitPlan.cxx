@@ -0,0 +1,147 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+#include <algorithm>
+
+#include <dds/core/Exception.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+
+#include "SplitPlan.hpp"
+
+using namespace dds::core::xtypes;
+
+
+SplitPlan::SplitPlan(
+        const DynamicType &type,
+        const std::vector<std::vector<std::string>> &cleared_members)
+{
+    const DynamicType resolved_type = rti::core::xtypes::resolve_alias(type);
+    if (resolved_type.kind() != TypeKind::STRUCTURE_TYPE) {
+        throw dds::core::InvalidArgumentError(
+                "type " + type.name() + " is not a structure");
+    }
+    const StructType &struct_type =
+            static_cast<const StructType &>(resolved_type);
+
+    std::vector<std::string> member_names;
+    for (uint32_t i = 0; i < struct_type.member_count(); ++i) {
+        member_names.push_back(struct_type.member(i).name());
+    }
+    for (const std::vector<std::string> &members : cleared_members) {
+        for (const std::string &name : members) {
+            if (std::find(member_names.begin(), member_names.end(), name)
+                == member_names.end()) {
+                throw dds::core::InvalidArgumentError(
+                        "type " + type.name() + " has no member " + name);
+            }
+        }
+        outputs_.push_back(DynamicData(type));
+    }
+
+    for (uint32_t i = 0; i < struct_type.member_count(); ++i) {
+        const Member &member = struct_type.member(i);
+        MemberMask mask {
+            i + 1,
+            member.name(),
+            static_cast<int32_t>(rti::core::xtypes::resolve_alias(member.type())
+                                         .kind()
+                                         .underlying()),
+            member.is_optional(),
+            {}
+        };
+        for (size_t output = 0; output < cleared_members.size(); ++output) {
+            const std::vector<std::string> &members = cleared_members[output];
+            if (std::find(members.begin(), members.end(), member.name())
+                == members.end()) {
+                mask.outputs.push_back(output);
+            }
+        }
+        // Members cleared in every output are never read
+        if (!mask.outputs.empty()) {
+            members_.push_back(mask);
+        }
+    }
+}
+
+template<typename T>
+void SplitPlan::copy_member(const DynamicData &input, const MemberMask &member)
+{
+    T value = input.value<T>(member.index);
+    for (size_t output : member.outputs) {
+        outputs_[output].value<T>(member.index, value);
+    }
+}
+
+void SplitPlan::split(const DynamicData &input)
+{
+    for (const MemberMask &member : members_) {
+        if (member.optional && !input.member_exists(member.index)) {
+            for (size_t output : member.outputs) {
+                outputs_[output].clear_member(member.name);
+            }
+            continue;
+        }
+
+        switch (member.kind) {
+        case TypeKind::BOOLEAN_TYPE:
+            copy_member<DDS_Boolean>(input, member);
+            break;
+        case TypeKind::CHAR_8_TYPE:
+            copy_member<DDS_Char>(input, member);
+            break;
+        case TypeKind::UINT_8_TYPE:
+            copy_member<uint8_t>(input, member);
+            break;
+        case TypeKind::INT_16_TYPE:
+            copy_member<int16_t>(input, member);
+            break;
+        case TypeKind::UINT_16_TYPE:
+            copy_member<uint16_t>(input, member);
+            break;
+        case TypeKind::INT_32_TYPE:
+        case TypeKind::ENUMERATION_TYPE:
+            copy_member<int32_t>(input, member);
+            break;
+        case TypeKind::UINT_32_TYPE:
+            copy_member<uint32_t>(input, member);
+            break;
+        case TypeKind::INT_64_TYPE:
+            copy_member<int64_t>(input, member);
+            break;
+        case TypeKind::UINT_64_TYPE:
+            copy_member<uint64_t>(input, member);
+            break;
+        case TypeKind::FLOAT_32_TYPE:
+            copy_member<float>(input, member);
+            break;
+        case TypeKind::FLOAT_64_TYPE:
+            copy_member<double>(input, member);
+            break;
+        case TypeKind::STRING_TYPE:
+            copy_member<std::string>(input, member);
+            break;
+        default:
+            // Structures, collections and unions are copied as a whole
+            copy_member<DynamicData>(input, member);
+            break;
+        }
+    }
+}
+
+const DynamicData &SplitPlan::output(size_t index) const
+{
+    return outputs_.at(index);
+}
+
+size_t SplitPlan::output_count() const
+{
+    return outputs_.size();
+}
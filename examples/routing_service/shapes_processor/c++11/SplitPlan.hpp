@@ -0,0 +1,87 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef SPLIT_PLAN_HPP_
+#define SPLIT_PLAN_HPP_
+
+#include <string>
+#include <vector>
+
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/DynamicType.hpp>
+
+/**
+ * @brief Plan to split samples of a given type into several output samples,
+ * each one with some of the members of the input left to their default value.
+ *
+ * Assigning the input sample to each output and then clearing some members
+ * copies the whole sample once per output. The plan instead creates an output
+ * sample per output once, and precomputes for each member of the type the
+ * mask of outputs it's copied into. split() then reads each member of the
+ * input once and writes it only into the outputs of its mask, while the
+ * cleared members of the outputs are never written and keep their default
+ * value.
+ *
+ * The output samples are reused by each split(), so a plan can't be used from
+ * multiple threads at the same time.
+ */
+class SplitPlan {
+public:
+    /**
+     * @brief Creates the plan for a structure type.
+     *
+     * @param type
+     *      Type of the input and output samples.
+     * @param cleared_members
+     *      For each output, the names of the top-level members that are left
+     *      to their default value.
+     */
+    SplitPlan(
+            const dds::core::xtypes::DynamicType &type,
+            const std::vector<std::vector<std::string>> &cleared_members);
+
+    /**
+     * @brief Copies the members of an input sample into the output samples.
+     */
+    void split(const dds::core::xtypes::DynamicData &input);
+
+    /**
+     * @brief Returns the sample of an output after the last split().
+     */
+    const dds::core::xtypes::DynamicData &output(size_t index) const;
+
+    size_t output_count() const;
+
+private:
+    /**
+     * @brief Member of the type and the outputs it's copied into
+     */
+    struct MemberMask {
+        // 1-based index of the member in the structure
+        uint32_t index;
+        std::string name;
+        // Kind of the member (TypeKind underlying value)
+        int32_t kind;
+        bool optional;
+        std::vector<size_t> outputs;
+    };
+
+    template<typename T>
+    void copy_member(
+            const dds::core::xtypes::DynamicData &input,
+            const MemberMask &member);
+
+    std::vector<MemberMask> members_;
+    std::vector<dds::core::xtypes::DynamicData> outputs_;
+};
+
+#endif
@@ -0,0 +1,515 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+#include <algorithm>
+#include <iterator>
+
+#include <dds/core/corefwd.hpp>
+
+#include <dds/core/Exception.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+#include <rti/routing/Logger.hpp>
+#include <rti/routing/processor/Processor.hpp>
+#include <rti/routing/processor/ProcessorPlugin.hpp>
+
+#include "PropertyList.hpp"
+#include "StreamJoiner.hpp"
+
+using namespace rti::routing;
+using namespace rti::routing::processor;
+using namespace dds::core::xtypes;
+
+
+const std::string StreamJoinerProperty::INPUTS = "join.inputs";
+const std::string StreamJoinerProperty::KEY = "join.key";
+const std::string StreamJoinerProperty::WINDOW_MS = "join.window_ms";
+const std::string StreamJoinerProperty::MAX_KEYS = "join.max_keys";
+const std::string StreamJoinerProperty::OUTPUT_MAPPING = "join.output_mapping";
+const std::string StreamJoinerProperty::TRIGGER_INPUT = "join.trigger_input";
+
+/*
+ * --- Helpers ----------------------------------------------------------------
+ */
+
+static std::string get_property(
+        const rti::routing::PropertySet &properties,
+        const std::string &name,
+        const std::string &default_value,
+        bool required)
+{
+    rti::routing::PropertySet::const_iterator it = properties.find(name);
+    if (it == properties.end()) {
+        if (required) {
+            throw dds::core::InvalidArgumentError(
+                    "missing required property " + name);
+        }
+        return default_value;
+    }
+    return it->second;
+}
+
+static size_t get_positive_property(
+        const rti::routing::PropertySet &properties,
+        const std::string &name,
+        size_t default_value)
+{
+    std::string value = get_property(properties, name, "", false);
+    if (value.empty()) {
+        return default_value;
+    }
+
+    int64_t number = 0;
+    try {
+        number = std::stoll(value);
+    } catch (const std::exception &) {
+        number = 0;
+    }
+    if (number <= 0) {
+        throw dds::core::InvalidArgumentError(
+                "invalid value for property " + name + ": " + value);
+    }
+    return static_cast<size_t>(number);
+}
+
+/**
+ * @brief Calls the visitor with the structure that contains the member at the
+ * end of the path, and the name of the member, loaning the intermediate
+ * members of the path.
+ */
+template<typename Visitor>
+static void visit_member(
+        DynamicData &data,
+        const std::vector<std::string> &path,
+        size_t level,
+        Visitor visitor)
+{
+    if (level + 1 == path.size()) {
+        visitor(data, path[level]);
+        return;
+    }
+
+    rti::core::xtypes::LoanedDynamicData member =
+            data.loan_value(path[level]);
+    visit_member(member.get(), path, level + 1, visitor);
+}
+
+/**
+ * @brief Returns the value of a key member as a string, which identifies the
+ * key in the hash table.
+ */
+static std::string key_string(DynamicData &data, const std::string &name)
+{
+    switch (data.member_info(name).member_kind().underlying()) {
+    case TypeKind::STRING_TYPE:
+        return data.value<std::string>(name);
+    case TypeKind::CHAR_8_TYPE:
+        return std::string(1, data.value<DDS_Char>(name));
+    case TypeKind::UINT_8_TYPE:
+        return std::to_string(data.value<uint8_t>(name));
+    case TypeKind::INT_16_TYPE:
+        return std::to_string(data.value<int16_t>(name));
+    case TypeKind::UINT_16_TYPE:
+        return std::to_string(data.value<uint16_t>(name));
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::ENUMERATION_TYPE:
+        return std::to_string(data.value<int32_t>(name));
+    case TypeKind::UINT_32_TYPE:
+        return std::to_string(data.value<uint32_t>(name));
+    case TypeKind::INT_64_TYPE:
+        return std::to_string(data.value<int64_t>(name));
+    case TypeKind::UINT_64_TYPE:
+        return std::to_string(data.value<uint64_t>(name));
+    default:
+        throw dds::core::InvalidArgumentError(
+                "unsupported type for key member=" + name);
+    }
+}
+
+/**
+ * @brief Copies the value of a member into another member of the same type.
+ */
+static void copy_value(
+        DynamicData &output,
+        const std::string &output_name,
+        DynamicData &input,
+        const std::string &input_name)
+{
+    switch (input.member_info(input_name).member_kind().underlying()) {
+    case TypeKind::BOOLEAN_TYPE:
+        output.value<bool>(output_name, input.value<bool>(input_name));
+        break;
+    case TypeKind::CHAR_8_TYPE:
+        output.value<DDS_Char>(output_name, input.value<DDS_Char>(input_name));
+        break;
+    case TypeKind::UINT_8_TYPE:
+        output.value<uint8_t>(output_name, input.value<uint8_t>(input_name));
+        break;
+    case TypeKind::INT_16_TYPE:
+        output.value<int16_t>(output_name, input.value<int16_t>(input_name));
+        break;
+    case TypeKind::UINT_16_TYPE:
+        output.value<uint16_t>(
+                output_name,
+                input.value<uint16_t>(input_name));
+        break;
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::ENUMERATION_TYPE:
+        output.value<int32_t>(output_name, input.value<int32_t>(input_name));
+        break;
+    case TypeKind::UINT_32_TYPE:
+        output.value<uint32_t>(
+                output_name,
+                input.value<uint32_t>(input_name));
+        break;
+    case TypeKind::INT_64_TYPE:
+        output.value<int64_t>(output_name, input.value<int64_t>(input_name));
+        break;
+    case TypeKind::UINT_64_TYPE:
+        output.value<uint64_t>(
+                output_name,
+                input.value<uint64_t>(input_name));
+        break;
+    case TypeKind::FLOAT_32_TYPE:
+        output.value<float>(output_name, input.value<float>(input_name));
+        break;
+    case TypeKind::FLOAT_64_TYPE:
+        output.value<double>(output_name, input.value<double>(input_name));
+        break;
+    case TypeKind::STRING_TYPE:
+        output.value<std::string>(
+                output_name,
+                input.value<std::string>(input_name));
+        break;
+    default:
+        // Structures, collections and unions are copied as a whole
+        output.value(output_name, input.value<DynamicData>(input_name));
+        break;
+    }
+}
+
+
+/*
+ * --- StreamJoiner -----------------------------------------------------------
+ */
+
+StreamJoiner::StreamJoiner(const rti::routing::PropertySet &properties)
+        : input_names_(split_property_list(
+                get_property(
+                        properties,
+                        StreamJoinerProperty::INPUTS,
+                        "",
+                        true),
+                ',')),
+          key_path_(split_property_list(
+                  get_property(
+                          properties,
+                          StreamJoinerProperty::KEY,
+                          "",
+                          true),
+                  '.')),
+          window_(get_positive_property(
+                  properties,
+                  StreamJoinerProperty::WINDOW_MS,
+                  1000)),
+          max_keys_(get_positive_property(
+                  properties,
+                  StreamJoinerProperty::MAX_KEYS,
+                  1024))
+{
+    auto input_index = [this](const std::string &name) {
+        auto it = std::find(input_names_.begin(), input_names_.end(), name);
+        if (it == input_names_.end()) {
+            throw dds::core::InvalidArgumentError(
+                    "unknown input in processor properties: " + name);
+        }
+        return static_cast<size_t>(it - input_names_.begin());
+    };
+
+    for (const std::string &assignment : split_property_list(
+                 get_property(
+                         properties,
+                         StreamJoinerProperty::OUTPUT_MAPPING,
+                         "",
+                         true),
+                 ',')) {
+        std::vector<std::string> sides =
+                split_property_list(assignment, '=');
+        if (sides.size() != 2 || sides[0].empty() || sides[1].empty()) {
+            throw dds::core::InvalidArgumentError(
+                    "invalid output mapping: " + assignment);
+        }
+
+        Assignment mapping;
+        if (sides[0] == "*") {
+            mapping.input = input_index(sides[1]);
+        } else {
+            size_t dot = sides[1].find('.');
+            if (dot == std::string::npos) {
+                throw dds::core::InvalidArgumentError(
+                        "missing input member in output mapping: "
+                        + assignment);
+            }
+            mapping.output_path = split_property_list(sides[0], '.');
+            mapping.input = input_index(sides[1].substr(0, dot));
+            mapping.input_path =
+                    split_property_list(sides[1].substr(dot + 1), '.');
+        }
+        output_mapping_.push_back(mapping);
+    }
+
+    std::string trigger_input = get_property(
+            properties,
+            StreamJoinerProperty::TRIGGER_INPUT,
+            "",
+            false);
+    trigger_input_ = trigger_input.empty() ? input_names_.size()
+                                           : input_index(trigger_input);
+
+    // The disposals of an input can only be forwarded if it maps the key
+    for (size_t i = 0; i < input_names_.size(); ++i) {
+        if (!forwards_disposals(i)) {
+            continue;
+        }
+        bool maps_key = std::any_of(
+                output_mapping_.begin(),
+                output_mapping_.end(),
+                [this, i](const Assignment &assignment) {
+                    return assignment.input == i
+                            && (assignment.output_path.empty()
+                                || assignment.output_path == key_path_);
+                });
+        if (!maps_key) {
+            throw dds::core::InvalidArgumentError(
+                    "output mapping doesn't assign the key from input="
+                    + input_names_[i] + ", set "
+                    + StreamJoinerProperty::TRIGGER_INPUT
+                    + " to an input that does");
+        }
+    }
+}
+
+StreamJoiner::~StreamJoiner()
+{
+}
+
+void StreamJoiner::on_output_enabled(
+        rti::routing::processor::Route &route,
+        rti::routing::processor::Output &output)
+{
+    // initialize the output_data buffer using the type from the output
+    output_data_ = output.get<DynamicData>().create_data();
+}
+
+void StreamJoiner::on_data_available(rti::routing::processor::Route &route)
+{
+    Clock::time_point now = Clock::now();
+    evict(now);
+
+    for (size_t i = 0; i < input_names_.size(); ++i) {
+        auto samples = route.input<DynamicData>(input_names_[i]).take();
+        for (auto sample : samples) {
+            try {
+                if (sample.info().valid()) {
+                    join(route, i, sample.data(), now);
+                } else if (forwards_disposals(i)) {
+                    forward_disposal(route, i, sample.data(), sample.info());
+                }
+            } catch (const std::exception &ex) {
+                rti::routing::Logger::instance().error(
+                        "cannot join sample of input=" + input_names_[i]
+                        + ": " + ex.what());
+            }
+        }
+    }
+}
+
+void StreamJoiner::join(
+        rti::routing::processor::Route &route,
+        size_t input,
+        const DynamicData &sample,
+        Clock::time_point now)
+{
+    // The copy is kept as the latest sample of the key
+    DynamicData data = sample;
+    std::string key = sample_key(data);
+
+    std::unordered_map<std::string, KeyState>::iterator it = keys_.find(key);
+    if (it == keys_.end()) {
+        KeyState state;
+        state.samples.resize(input_names_.size());
+        state.reception_times.resize(input_names_.size());
+        state.eviction_position =
+                eviction_order_.insert(eviction_order_.end(), key);
+        it = keys_.emplace(key, std::move(state)).first;
+        if (keys_.size() > max_keys_) {
+            // The least recently updated key makes room for the new one
+            keys_.erase(eviction_order_.front());
+            eviction_order_.pop_front();
+        }
+    } else {
+        eviction_order_.splice(
+                eviction_order_.end(),
+                eviction_order_,
+                it->second.eviction_position);
+    }
+
+    KeyState &state = it->second;
+    state.samples[input] = std::move(data);
+    state.reception_times[input] = now;
+
+    if (trigger_input_ != input_names_.size() && trigger_input_ != input) {
+        return;
+    }
+    for (size_t i = 0; i < input_names_.size(); ++i) {
+        if (!state.samples[i].is_set()
+            || now - state.reception_times[i] > window_) {
+            return;
+        }
+    }
+
+    assemble(state);
+    route.output<DynamicData>(0).write(output_data_.get());
+}
+
+void StreamJoiner::forward_disposal(
+        rti::routing::processor::Route &route,
+        size_t input,
+        const DynamicData &sample,
+        const dds::sub::SampleInfo &info)
+{
+    DynamicData key_sample = sample;
+    std::unordered_map<std::string, KeyState>::iterator it =
+            keys_.find(sample_key(key_sample));
+    if (it != keys_.end()) {
+        // The instance is gone, so it's no longer joined with the other inputs
+        it->second.samples[input].reset();
+    }
+
+    // The output is shared by all the keys, so nothing of the last joined
+    // sample can be left in it
+    output_data_.get().clear_all_members();
+    for (const Assignment &assignment : output_mapping_) {
+        if (assignment.input == input) {
+            assign(assignment, key_sample);
+        }
+    }
+    // The key identifies the instance, whatever input member it's mapped from
+    copy_member(key_sample, key_path_, key_path_);
+    route.output<DynamicData>(0).write(output_data_.get(), info);
+}
+
+bool StreamJoiner::forwards_disposals(size_t input) const
+{
+    return trigger_input_ == input_names_.size() || trigger_input_ == input;
+}
+
+std::string StreamJoiner::sample_key(DynamicData &sample) const
+{
+    std::string key;
+    visit_member(
+            sample,
+            key_path_,
+            0,
+            [&key](DynamicData &parent, const std::string &name) {
+                key = key_string(parent, name);
+            });
+    return key;
+}
+
+void StreamJoiner::assemble(KeyState &state)
+{
+    for (const Assignment &assignment : output_mapping_) {
+        assign(assignment, state.samples[assignment.input].get());
+    }
+}
+
+void StreamJoiner::assign(const Assignment &assignment, DynamicData &input)
+{
+    if (assignment.output_path.empty()) {
+        output_data_ = input;
+        return;
+    }
+    copy_member(input, assignment.input_path, assignment.output_path);
+}
+
+void StreamJoiner::copy_member(
+        DynamicData &input,
+        const MemberPath &input_path,
+        const MemberPath &output_path)
+{
+    visit_member(
+            input,
+            input_path,
+            0,
+            [this, &output_path](
+                    DynamicData &input_parent,
+                    const std::string &input_name) {
+                visit_member(
+                        output_data_.get(),
+                        output_path,
+                        0,
+                        [&input_parent, &input_name](
+                                DynamicData &output_parent,
+                                const std::string &output_name) {
+                            copy_value(
+                                    output_parent,
+                                    output_name,
+                                    input_parent,
+                                    input_name);
+                        });
+            });
+}
+
+void StreamJoiner::evict(Clock::time_point now)
+{
+    // The keys are sorted by their last update, so the expired ones are first
+    while (!eviction_order_.empty()) {
+        const KeyState &state = keys_.at(eviction_order_.front());
+        Clock::time_point last_update = *std::max_element(
+                state.reception_times.begin(),
+                state.reception_times.end());
+        if (now - last_update <= window_) {
+            break;
+        }
+        keys_.erase(eviction_order_.front());
+        eviction_order_.pop_front();
+    }
+}
+
+
+/*
+ * --- StreamJoinerPlugin -----------------------------------------------------
+ */
+
+StreamJoinerPlugin::StreamJoinerPlugin(const rti::routing::PropertySet &)
+{
+    rti::routing::Logger::instance().local("StreamJoiner Plugin loaded");
+}
+
+
+rti::routing::processor::Processor *StreamJoinerPlugin::create_processor(
+        rti::routing::processor::Route &,
+        const rti::routing::PropertySet &properties)
+{
+    rti::routing::Logger::instance().local("StreamJoiner Processor created");
+    return new StreamJoiner(properties);
+}
+
+void StreamJoinerPlugin::delete_processor(
+        rti::routing::processor::Route &,
+        rti::routing::processor::Processor *processor)
+{
+    delete processor;
+}
+
+
+RTI_PROCESSOR_PLUGIN_CREATE_FUNCTION_DEF(StreamJoinerPlugin);
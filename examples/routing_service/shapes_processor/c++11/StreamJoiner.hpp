@@ -0,0 +1,211 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef STREAM_JOINER_HPP_
+#define STREAM_JOINER_HPP_
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dds/core/corefwd.hpp>
+
+#include <dds/core/Optional.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+#include <rti/routing/processor/Processor.hpp>
+#include <rti/routing/processor/ProcessorPlugin.hpp>
+
+/**
+ * Names of the properties of the StreamJoiner processor.
+ */
+struct StreamJoinerProperty {
+    // Comma-separated names of the inputs to join. Required.
+    static const std::string INPUTS;
+    // Path of the key member in the samples of every input, with nested
+    // members separated by dots. Required.
+    static const std::string KEY;
+    // Time in milliseconds a sample stays eligible to be joined. Default: 1000
+    static const std::string WINDOW_MS;
+    // Maximum number of keys with state. Default: 1024
+    static const std::string MAX_KEYS;
+    // Comma-separated assignments of the output members, applied in order.
+    // Required. Each assignment is either:
+    // - <output member path>=<input>.<input member path>
+    // - *=<input>, which copies the whole sample of the input.
+    static const std::string OUTPUT_MAPPING;
+    // Name of the only input whose samples produce joined samples and whose
+    // disposals are forwarded. Default: empty, any input. Each of those inputs
+    // must assign the output member at the KEY path.
+    static const std::string TRIGGER_INPUT;
+};
+
+/**
+ * Processor that joins the samples of N inputs with the same value of a key
+ * member within a time window, and writes the joined samples into its single
+ * output.
+ *
+ * For each key, it keeps the latest sample of each input in a hash table.
+ * When a sample arrives and every input has a sample for its key received
+ * within the window, a joined sample is assembled with the output mapping and
+ * written.
+ *
+ * The keys are evicted in least-recently-updated order, either once none of
+ * their samples is within the window or when the table exceeds its maximum
+ * number of keys, so the state is bounded.
+ *
+ * The disposals and unregistrations of the trigger input, or of any input
+ * without one, are written into the output with the key of the instance in
+ * the member at the key path, and the other members cleared or assigned from
+ * the disposed sample.
+ */
+class StreamJoiner : public rti::routing::processor::NoOpProcessor {
+public:
+    void on_data_available(rti::routing::processor::Route &) override;
+
+    void on_output_enabled(
+            rti::routing::processor::Route &route,
+            rti::routing::processor::Output &output) override;
+
+    StreamJoiner(const rti::routing::PropertySet &properties);
+
+    ~StreamJoiner();
+
+private:
+    typedef std::vector<std::string> MemberPath;
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Assignment of an output member from an input member
+     */
+    struct Assignment {
+        // Empty to assign the whole sample
+        MemberPath output_path;
+        size_t input;
+        MemberPath input_path;
+    };
+
+    /**
+     * @brief Latest samples of a key
+     */
+    struct KeyState {
+        std::vector<dds::core::optional<dds::core::xtypes::DynamicData>>
+                samples;
+        std::vector<Clock::time_point> reception_times;
+        // Position of the key in the eviction order
+        std::list<std::string>::iterator eviction_position;
+    };
+
+    /**
+     * @brief Stores the sample of an input and writes the joined sample, if
+     * complete.
+     */
+    void join(
+            rti::routing::processor::Route &route,
+            size_t input,
+            const dds::core::xtypes::DynamicData &sample,
+            Clock::time_point now);
+
+    /**
+     * @brief Writes the disposal or unregistration of an instance of an input
+     * into the output, with the key member set from its sample, and drops
+     * the sample of the input kept for its key.
+     */
+    void forward_disposal(
+            rti::routing::processor::Route &route,
+            size_t input,
+            const dds::core::xtypes::DynamicData &sample,
+            const dds::sub::SampleInfo &info);
+
+    /**
+     * @brief Whether the disposals of an input are written into the output.
+     */
+    bool forwards_disposals(size_t input) const;
+
+    /**
+     * @brief Returns the value of the key member of a sample as a string.
+     */
+    std::string sample_key(dds::core::xtypes::DynamicData &sample) const;
+
+    /**
+     * @brief Assembles the joined sample from the samples of a key into
+     * output_data_.
+     */
+    void assemble(KeyState &state);
+
+    /**
+     * @brief Applies an assignment of the output mapping from the sample of
+     * its input to output_data_.
+     */
+    void assign(
+            const Assignment &assignment,
+            dds::core::xtypes::DynamicData &input);
+
+    /**
+     * @brief Copies the member of an input sample at a path into the member
+     * of output_data_ at another path.
+     */
+    void copy_member(
+            dds::core::xtypes::DynamicData &input,
+            const MemberPath &input_path,
+            const MemberPath &output_path);
+
+    void evict(Clock::time_point now);
+
+    std::vector<std::string> input_names_;
+    MemberPath key_path_;
+    std::chrono::milliseconds window_;
+    size_t max_keys_;
+    std::vector<Assignment> output_mapping_;
+    // Index of the trigger input, or the number of inputs for any of them
+    size_t trigger_input_;
+
+    std::unordered_map<std::string, KeyState> keys_;
+    // Keys from the least to the most recently updated
+    std::list<std::string> eviction_order_;
+
+    // Optional member for deferred initialization: this object can be created
+    // only when the output is enabled.
+    // You can use std::optional if supported in your platform
+    dds::core::optional<dds::core::xtypes::DynamicData> output_data_;
+};
+
+
+class StreamJoinerPlugin : public rti::routing::processor::ProcessorPlugin {
+public:
+    rti::routing::processor::Processor *create_processor(
+            rti::routing::processor::Route &route,
+            const rti::routing::PropertySet &properties) override;
+
+    void delete_processor(
+            rti::routing::processor::Route &route,
+            rti::routing::processor::Processor *processor) override;
+
+    StreamJoinerPlugin(const rti::routing::PropertySet &properties);
+};
+
+
+/**
+ * This macro defines a C-linkage symbol that can be used as create function
+ * for plug-in registration through XML.
+ *
+ * The generated symbol has the name:
+ *
+ * \code
+ * StreamJoinerPlugin_create_processor_plugin
+ * \endcode
+ */
+RTI_PROCESSOR_PLUGIN_CREATE_FUNCTION_DECL(StreamJoinerPlugin);
+
+#endif
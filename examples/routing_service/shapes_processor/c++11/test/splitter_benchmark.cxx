@@ -0,0 +1,159 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Benchmark of the creation of the output samples of the ShapesSplitter.
+ *
+ * It doesn't need Routing Service: a ShapeType sample is split in memory into
+ * 1, 4 and 16 outputs, alternately with y and x left to zero, and the input
+ * samples/s of each splitter mode are reported:
+ *
+ * - copy: the input sample is assigned to each output sample, and then the
+ *   cleared member is reset.
+ * - member_mask: a SplitPlan copies each member of the input once into the
+ *   reused samples of the outputs that keep it.
+ *
+ * Each measure also checks that both modes produce the same output samples.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/PrimitiveTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+
+#include "SplitPlan.hpp"
+
+using namespace dds::core::xtypes;
+
+/**
+ * @brief Parses the optional --iterations <n>. Returns false if the arguments
+ * are not valid.
+ */
+static bool parse_iterations(int argc, char *argv[], uint32_t &iterations)
+{
+    if (argc == 1) {
+        return true;
+    }
+    if (argc != 3 || std::string(argv[1]) != "--iterations") {
+        return false;
+    }
+    try {
+        iterations = static_cast<uint32_t>(std::stoul(argv[2]));
+    } catch (const std::exception &) {
+        return false;
+    }
+    return iterations > 0;
+}
+
+/**
+ * @brief Runs a split the given number of times and prints the input
+ * samples/s.
+ */
+static void measure(
+        const std::string &name,
+        uint32_t iterations,
+        const std::function<void()> &split)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        split();
+    }
+    double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    std::cout << "    " << name << ": " << iterations / seconds
+              << " samples/s\n";
+}
+
+static DynamicData create_shape_sample()
+{
+    StructType type("ShapeType");
+    type.add_member(Member("color", StringType(128)).key(true));
+    type.add_member(Member("x", primitive_type<int32_t>()));
+    type.add_member(Member("y", primitive_type<int32_t>()));
+    type.add_member(Member("shapesize", primitive_type<int32_t>()));
+
+    DynamicData sample(type);
+    sample.value<std::string>("color", "BLUE");
+    sample.value<int32_t>("x", 100);
+    sample.value<int32_t>("y", 150);
+    sample.value<int32_t>("shapesize", 30);
+    return sample;
+}
+
+static bool run_outputs(
+        const DynamicData &sample,
+        size_t output_count,
+        uint32_t iterations)
+{
+    // Same cleared members as the default configuration, repeated
+    std::vector<std::vector<std::string>> cleared_members;
+    for (size_t i = 0; i < output_count; ++i) {
+        cleared_members.push_back({ i % 2 == 0 ? "y" : "x" });
+    }
+
+    std::vector<DynamicData> copies(output_count, DynamicData(sample.type()));
+    auto copy_split = [&sample, &cleared_members, &copies]() {
+        for (size_t i = 0; i < copies.size(); ++i) {
+            copies[i] = sample;
+            for (const std::string &member : cleared_members[i]) {
+                copies[i].clear_member(member);
+            }
+        }
+    };
+    SplitPlan plan(sample.type(), cleared_members);
+    auto mask_split = [&sample, &plan]() { plan.split(sample); };
+
+    std::cout << output_count << " output" << (output_count > 1 ? "s" : "")
+              << "\n";
+    measure("copy", iterations, copy_split);
+    measure("member_mask", iterations, mask_split);
+
+    bool equal = true;
+    for (size_t i = 0; i < output_count; ++i) {
+        equal = equal && copies[i] == plan.output(i);
+    }
+    if (!equal) {
+        std::cout << "    MISMATCH between the outputs of both modes\n";
+    }
+    return equal;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = 100000;
+    if (!parse_iterations(argc, argv, iterations)) {
+        std::cout << "Usage: splitter_benchmark [--iterations <n>]\n"
+                  << "    Input samples per measure (default 100000)\n";
+        return EXIT_FAILURE;
+    }
+
+    bool passed = true;
+    try {
+        DynamicData sample = create_shape_sample();
+        for (size_t output_count : { 1, 4, 16 }) {
+            passed = run_outputs(sample, output_count, iterations)
+                    && passed;
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
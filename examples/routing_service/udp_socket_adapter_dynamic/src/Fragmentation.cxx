@@ -0,0 +1,187 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "Fragmentation.hpp"
+
+#include <cstring>
+#ifdef _WIN32
+    #include <winsock2.h>
+#else
+    #include <arpa/inet.h>
+#endif
+
+void serialize_fragment_header(const FragmentHeader &header, char *buffer)
+{
+    uint32_t magic = htonl(header.magic);
+    uint32_t message_id = htonl(header.message_id);
+    uint16_t fragment_index = htons(header.fragment_index);
+    uint16_t fragment_count = htons(header.fragment_count);
+    uint32_t total_size = htonl(header.total_size);
+
+    memcpy(buffer, &magic, 4);
+    memcpy(buffer + 4, &message_id, 4);
+    memcpy(buffer + 8, &fragment_index, 2);
+    memcpy(buffer + 10, &fragment_count, 2);
+    memcpy(buffer + 12, &total_size, 4);
+}
+
+bool deserialize_fragment_header(
+        const char *buffer,
+        size_t size,
+        FragmentHeader &header)
+{
+    if (size < FRAGMENT_HEADER_SIZE) {
+        return false;
+    }
+
+    memcpy(&header.magic, buffer, 4);
+    memcpy(&header.message_id, buffer + 4, 4);
+    memcpy(&header.fragment_index, buffer + 8, 2);
+    memcpy(&header.fragment_count, buffer + 10, 2);
+    memcpy(&header.total_size, buffer + 12, 4);
+    header.magic = ntohl(header.magic);
+    header.message_id = ntohl(header.message_id);
+    header.fragment_index = ntohs(header.fragment_index);
+    header.fragment_count = ntohs(header.fragment_count);
+    header.total_size = ntohl(header.total_size);
+
+    return header.magic == FRAGMENT_HEADER_MAGIC && header.fragment_count > 0
+            && header.fragment_index < header.fragment_count;
+}
+
+FragmentReassembler::FragmentReassembler(
+        size_t max_sample_size,
+        size_t memory_cap,
+        std::chrono::milliseconds timeout)
+        : max_sample_size_(max_sample_size),
+          memory_cap_(memory_cap),
+          timeout_(timeout),
+          memory_used_(0),
+          dropped_count_(0)
+{
+}
+
+const std::vector<char> *FragmentReassembler::add_fragment(
+        const char *datagram,
+        size_t size,
+        uint32_t source_address,
+        uint16_t source_port)
+{
+    FragmentHeader header;
+    if (!deserialize_fragment_header(datagram, size, header)
+        || header.total_size > max_sample_size_) {
+        ++dropped_count_;
+        return nullptr;
+    }
+
+    const char *payload = datagram + FRAGMENT_HEADER_SIZE;
+    size_t payload_size = size - FRAGMENT_HEADER_SIZE;
+
+    // Samples that fit in one datagram don't need to be reassembled
+    if (header.fragment_count == 1) {
+        if (payload_size != header.total_size) {
+            ++dropped_count_;
+            return nullptr;
+        }
+        complete_sample_.assign(payload, payload + payload_size);
+        return &complete_sample_;
+    }
+
+    Clock::time_point now = Clock::now();
+    discard_expired(now);
+
+    SampleId id;
+    id.source_address = source_address;
+    id.source_port = source_port;
+    id.message_id = header.message_id;
+    auto index_it = partial_sample_index_.find(id);
+    PartialSampleIterator it;
+    if (index_it == partial_sample_index_.end()) {
+        if (header.total_size > memory_cap_) {
+            ++dropped_count_;
+            return nullptr;
+        }
+        while (memory_used_ + header.total_size > memory_cap_) {
+            discard(partial_samples_.begin());
+        }
+
+        it = partial_samples_.insert(partial_samples_.end(), PartialSample());
+        it->id = id;
+        it->data.resize(header.total_size);
+        it->received.assign(header.fragment_count, false);
+        it->received_count = 0;
+        it->first_fragment_time = now;
+        memory_used_ += header.total_size;
+        partial_sample_index_.emplace(id, it);
+    } else {
+        it = index_it->second;
+    }
+
+    PartialSample &sample = *it;
+
+    /**
+     * All the fragments but the last one carry the same amount of data, so
+     * the position of a fragment in the sample can be computed from its
+     * index. A fragment that doesn't match the sample is discarded alone.
+     */
+    size_t fragment_payload_size = header.fragment_index + 1
+                    < header.fragment_count
+            ? payload_size
+            : (sample.data.size() - payload_size) / header.fragment_index;
+    size_t offset = fragment_payload_size * header.fragment_index;
+    if (sample.received.size() != header.fragment_count
+        || sample.data.size() != header.total_size
+        || offset + payload_size > sample.data.size()) {
+        return nullptr;
+    }
+
+    if (!sample.received[header.fragment_index]) {
+        memcpy(&sample.data[offset], payload, payload_size);
+        sample.received[header.fragment_index] = true;
+        ++sample.received_count;
+    }
+    if (sample.received_count < header.fragment_count) {
+        return nullptr;
+    }
+
+    memory_used_ -= sample.data.size();
+    complete_sample_.swap(sample.data);
+    remove(it);
+    return &complete_sample_;
+}
+
+uint64_t FragmentReassembler::dropped_count() const
+{
+    return dropped_count_;
+}
+
+void FragmentReassembler::discard_expired(Clock::time_point now)
+{
+    // The samples are sorted by arrival, so the expired ones are first
+    while (!partial_samples_.empty()
+           && now - partial_samples_.front().first_fragment_time > timeout_) {
+        discard(partial_samples_.begin());
+    }
+}
+
+void FragmentReassembler::discard(PartialSampleIterator sample)
+{
+    memory_used_ -= sample->data.size();
+    ++dropped_count_;
+    remove(sample);
+}
+
+void FragmentReassembler::remove(PartialSampleIterator sample)
+{
+    partial_sample_index_.erase(sample->id);
+    partial_samples_.erase(sample);
+}
@@ -0,0 +1,150 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef FRAGMENTATION_HPP
+#define FRAGMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * When fragmentation is enabled, every datagram starts with this header,
+ * followed by a piece of the serialized sample. All the fields are sent in
+ * network byte order.
+ */
+struct FragmentHeader {
+    uint32_t magic;
+    // Identifies the sample among the ones of its sender, all its fragments
+    // have the same message_id
+    uint32_t message_id;
+    uint16_t fragment_index;
+    uint16_t fragment_count;
+    // Size of the whole serialized sample
+    uint32_t total_size;
+};
+
+#define FRAGMENT_HEADER_MAGIC 0x52544946 // "RTIF"
+#define FRAGMENT_HEADER_SIZE 16
+
+/**
+ * @brief Writes the header of a fragment at the beginning of buffer, which
+ * must have room for FRAGMENT_HEADER_SIZE bytes.
+ */
+void serialize_fragment_header(const FragmentHeader &header, char *buffer);
+
+/**
+ * @brief Reads the header at the beginning of a datagram.
+ *
+ * @return false if the datagram is too short or doesn't start with a valid
+ * fragment header.
+ */
+bool deserialize_fragment_header(
+        const char *buffer,
+        size_t size,
+        FragmentHeader &header);
+
+/**
+ * @brief Rebuilds samples from their fragments.
+ *
+ * Fragments can arrive in any order. The fragments of a sample are the ones
+ * with its message_id sent from the same address and port, so senders can't
+ * mix their samples. A sample whose fragments don't all arrive within the
+ * timeout is discarded. The memory used by incomplete samples is limited to
+ * memory_cap bytes: when a new sample doesn't fit, the oldest incomplete
+ * samples are discarded to make room for it.
+ */
+class FragmentReassembler {
+public:
+    FragmentReassembler(
+            size_t max_sample_size,
+            size_t memory_cap,
+            std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Adds a datagram received from source_address and source_port,
+     * both in network byte order.
+     *
+     * @return the complete serialized sample if this was its last missing
+     * fragment, nullptr otherwise. The sample is valid until the next call.
+     */
+    const std::vector<char> *add_fragment(
+            const char *datagram,
+            size_t size,
+            uint32_t source_address,
+            uint16_t source_port);
+
+    /**
+     * @brief Number of samples discarded because of a timeout, the memory
+     * cap, or invalid fragments.
+     */
+    uint64_t dropped_count() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct SampleId {
+        uint32_t source_address;
+        uint16_t source_port;
+        uint32_t message_id;
+
+        bool operator==(const SampleId &other) const
+        {
+            return source_address == other.source_address
+                    && source_port == other.source_port
+                    && message_id == other.message_id;
+        }
+    };
+
+    struct SampleIdHash {
+        size_t operator()(const SampleId &id) const
+        {
+            uint64_t source = (static_cast<uint64_t>(id.source_address) << 16)
+                    | id.source_port;
+            return std::hash<uint64_t>()(source)
+                    ^ (std::hash<uint32_t>()(id.message_id) * 31);
+        }
+    };
+
+    struct PartialSample {
+        SampleId id;
+        std::vector<char> data;
+        std::vector<bool> received;
+        uint16_t received_count;
+        Clock::time_point first_fragment_time;
+    };
+
+    typedef std::list<PartialSample>::iterator PartialSampleIterator;
+
+    void discard_expired(Clock::time_point now);
+    // Drops an incomplete sample, counting it
+    void discard(PartialSampleIterator sample);
+    void remove(PartialSampleIterator sample);
+
+    size_t max_sample_size_;
+    size_t memory_cap_;
+    std::chrono::milliseconds timeout_;
+    size_t memory_used_;
+    uint64_t dropped_count_;
+    // Incomplete samples in the order their first fragment arrived, so the
+    // oldest ones are first
+    std::list<PartialSample> partial_samples_;
+    std::unordered_map<SampleId, PartialSampleIterator, SampleIdHash>
+            partial_sample_index_;
+    std::vector<char> complete_sample_;
+};
+
+#endif
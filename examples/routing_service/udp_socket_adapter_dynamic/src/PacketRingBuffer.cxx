@@ -0,0 +1,78 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "PacketRingBuffer.hpp"
+
+PacketRingBuffer::PacketRingBuffer(
+        size_t capacity,
+        size_t max_packet_size,
+        size_t reserved_packet_size)
+        : max_packet_size_(max_packet_size),
+          head_(0),
+          tail_(0),
+          dropped_count_(0)
+{
+    // A power of two capacity lets us wrap the indexes with a mask
+    size_t slot_count = 1;
+    while (slot_count < capacity) {
+        slot_count <<= 1;
+    }
+    mask_ = slot_count - 1;
+
+    slots_.resize(slot_count);
+    timestamps_.resize(slot_count);
+    for (auto &slot : slots_) {
+        slot.reserve(reserved_packet_size);
+    }
+}
+
+bool PacketRingBuffer::push(const char *data, size_t size, int64_t timestamp)
+{
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) > mask_
+        || size > max_packet_size_) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Within the capacity of the slot, assign() doesn't allocate
+    slots_[tail & mask_].assign(data, data + size);
+    timestamps_[tail & mask_] = timestamp;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+const std::vector<char> *PacketRingBuffer::front() const
+{
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &slots_[head & mask_];
+}
+
+int64_t PacketRingBuffer::front_timestamp() const
+{
+    return timestamps_[head_.load(std::memory_order_relaxed) & mask_];
+}
+
+void PacketRingBuffer::pop()
+{
+    head_.store(
+            head_.load(std::memory_order_relaxed) + 1,
+            std::memory_order_release);
+}
+
+size_t PacketRingBuffer::dropped_count() const
+{
+    return dropped_count_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,87 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef PACKETRINGBUFFER_HPP
+#define PACKETRINGBUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of packet slots.
+ *
+ * All the slots are allocated when the ring is created, with capacity for
+ * reserved_packet_size bytes each, so pushing packets up to that size never
+ * allocates memory.
+ * The socket reading thread is the only producer and take() the only
+ * consumer: the producer only writes tail_ and the consumer only writes
+ * head_, so no mutex is needed between them.
+ */
+class PacketRingBuffer {
+public:
+    /**
+     * @param capacity \b in. Number of slots, rounded up to a power of two.
+     * @param max_packet_size \b in. Max size of a packet stored in a slot.
+     * @param reserved_packet_size \b in. Bytes allocated upfront for each
+     * slot. A slot only allocates when it receives a packet larger than any
+     * previous one, up to max_packet_size.
+     */
+    PacketRingBuffer(
+            size_t capacity,
+            size_t max_packet_size,
+            size_t reserved_packet_size);
+
+    /**
+     * @brief Copies a packet, and the time it was received, in the next free
+     * slot. Called by the producer.
+     *
+     * @return false if the ring is full and the packet was dropped.
+     */
+    bool push(const char *data, size_t size, int64_t timestamp);
+
+    /**
+     * @brief Returns the oldest packet in the ring, or nullptr if the ring is
+     * empty. The packet stays valid until pop() is called. Called by the
+     * consumer.
+     */
+    const std::vector<char> *front() const;
+
+    /**
+     * @brief Returns the receive timestamp of the packet returned by front().
+     */
+    int64_t front_timestamp() const;
+
+    /**
+     * @brief Releases the slot returned by front(). Called by the consumer.
+     */
+    void pop();
+
+    /**
+     * @brief Number of packets dropped because the ring was full.
+     */
+    size_t dropped_count() const;
+
+private:
+    std::vector<std::vector<char>> slots_;
+    std::vector<int64_t> timestamps_;
+    size_t mask_;
+    size_t max_packet_size_;
+    // Index of the next slot to consume, only written by the consumer
+    std::atomic<size_t> head_;
+    // Index of the next slot to produce, only written by the producer
+    std::atomic<size_t> tail_;
+    std::atomic<size_t> dropped_count_;
+};
+
+#endif
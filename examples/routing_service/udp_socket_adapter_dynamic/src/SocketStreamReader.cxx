@@ -15,7 +15,6 @@
 #include <chrono>
 #include <sstream>
 #include <thread>
-#include <queue>
 
 #include <cstring>
 #include <iostream>
@@ -29,6 +28,7 @@
     #include <sys/types.h>
     #include <unistd.h>
 #endif
+#include <dds/dds.hpp>
 #include "SocketStreamReader.hpp"
 #include <rti/core/Exception.hpp>
 #include <rti/routing/Logger.hpp>
@@ -39,32 +39,62 @@ using namespace dds::core::xtypes;
 using namespace rti::routing;
 using namespace rti::routing::adapter;
 
-void SocketStreamReader::socket_reading_thread()
+static DDS_Time_t to_dds_time(int64_t time_ns)
 {
+    DDS_Time_t time;
+    time.sec = static_cast<DDS_Long>(time_ns / 1000000000LL);
+    time.nanosec = static_cast<DDS_UnsignedLong>(time_ns % 1000000000LL);
+    return time;
+}
+
+void SocketStreamReader::socket_reading_thread(ReceiveChannel *channel)
+{
+    UdpSocket *socket = channel->socket.get();
+    PacketRingBuffer *received_packets = channel->received_packets.get();
+    FragmentReassembler *reassembler = channel->reassembler.get();
+
     while (!stop_thread_) {
-        int received_bytes = 0;
-        socket->receive_data(
-                received_buffer_,
-                &received_bytes,
-                BUFFER_MAX_SIZE);
+        // Blocks until datagrams arrive or the socket is unblocked
+        int received_count = socket->receive_batch();
 
-        // Most likely received nothing or there was an error
         // Not doing any error handling here
-        if (received_bytes <= 0) {
-            // Sleep for a small period of time to avoid busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (received_count <= 0) {
             continue;
         }
 
-        {
-            std::lock_guard<std::mutex> lock(buffer_mutex_);
-            received_buffers_.emplace(received_buffer_, received_buffer_ + received_bytes);
+        // Packets that don't fit in the ring are dropped and counted
+        for (int i = 0; i < received_count; ++i) {
+            // Truncated datagrams are reported with size 0 and discarded
+            if (socket->datagram_size(i) <= 0) {
+                continue;
+            }
+            if (reassembler == nullptr) {
+                received_packets->push(
+                        socket->datagram(i),
+                        socket->datagram_size(i),
+                        socket->datagram_timestamp(i));
+                continue;
+            }
+
+            // Only complete samples are queued for take()
+            const struct sockaddr_in &source = socket->datagram_source(i);
+            const std::vector<char> *sample = reassembler->add_fragment(
+                    socket->datagram(i),
+                    socket->datagram_size(i),
+                    source.sin_addr.s_addr,
+                    source.sin_port);
+            // The sample is received when its last fragment is received
+            if (sample != nullptr) {
+                received_packets->push(
+                        sample->data(),
+                        sample->size(),
+                        socket->datagram_timestamp(i));
+            }
         }
 
+        // take() drains all the packets in the ring, one notification is enough
         reader_listener_->on_data_available(this);
     }
-
-    socket_connection_->dispose_discovery_stream(stream_info_);
 }
 
 SocketStreamReader::SocketStreamReader(
@@ -73,11 +103,27 @@ SocketStreamReader::SocketStreamReader(
         const PropertySet &properties,
         StreamReaderListener *listener)
         : stop_thread_(false),
+          receive_port_(0),
+          receive_batch_size_(RECEIVE_BATCH_SIZE_DEFAULT),
+          max_datagram_size_(BUFFER_MAX_SIZE),
+          malformed_count_(0),
+          latency_statistics_period_(0),
+          last_statistics_time_(UdpSocket::current_time_ns()),
           stream_info_(info.stream_name(), info.type_info().type_name())
 {
     socket_connection_ = connection;
     reader_listener_ = listener;
     adapter_type_ = static_cast<DynamicType *>(info.type_info().type_representation());
+    int receive_queue_size = RECEIVE_QUEUE_SIZE_DEFAULT;
+    int receive_socket_buffer_size = 0;
+    bool fragmentation = false;
+    size_t max_sample_size = MAX_SAMPLE_SIZE_DEFAULT;
+    int reassembly_timeout = REASSEMBLY_TIMEOUT_DEFAULT;
+    size_t reassembly_memory_cap = REASSEMBLY_MEMORY_CAP_DEFAULT;
+    int receive_socket_count = 1;
+    std::string multicast_group;
+    std::string multicast_interface = MULTICAST_INTERFACE_DEFAULT;
+    bool kernel_timestamps = true;
 
     // Parse the properties provided in the xml configuration file
     for (const auto &property : properties) {
@@ -85,53 +131,240 @@ SocketStreamReader::SocketStreamReader(
             receive_address_ = property.second;
         } else if (property.first == RECEIVE_PORT_STRING) {
             receive_port_ = std::stoi(property.second);
+        } else if (property.first == RECEIVE_BATCH_SIZE_STRING) {
+            receive_batch_size_ = std::stoi(property.second);
+        } else if (property.first == RECEIVE_QUEUE_SIZE_STRING) {
+            receive_queue_size = std::stoi(property.second);
+        } else if (property.first == MAX_DATAGRAM_SIZE_STRING) {
+            max_datagram_size_ = std::stoi(property.second);
+        } else if (property.first == RECEIVE_SOCKET_BUFFER_SIZE_STRING) {
+            receive_socket_buffer_size = std::stoi(property.second);
+        } else if (property.first == FRAGMENTATION_STRING) {
+            fragmentation = property.second == "true" || property.second == "1";
+        } else if (property.first == MAX_SAMPLE_SIZE_STRING) {
+            max_sample_size = std::stoul(property.second);
+        } else if (property.first == REASSEMBLY_TIMEOUT_STRING) {
+            reassembly_timeout = std::stoi(property.second);
+        } else if (property.first == REASSEMBLY_MEMORY_CAP_STRING) {
+            reassembly_memory_cap = std::stoul(property.second);
+        } else if (property.first == RECEIVE_SOCKET_COUNT_STRING) {
+            receive_socket_count = std::stoi(property.second);
+        } else if (property.first == MULTICAST_GROUP_STRING) {
+            multicast_group = property.second;
+        } else if (property.first == MULTICAST_INTERFACE_STRING) {
+            multicast_interface = property.second;
+        } else if (property.first == KERNEL_TIMESTAMPS_STRING) {
+            kernel_timestamps =
+                    property.second == "true" || property.second == "1";
+        } else if (property.first == LATENCY_STATISTICS_PERIOD_STRING) {
+            latency_statistics_period_ =
+                    std::stoll(property.second) * 1000000LL;
         }
     }
 
-    socket = std::unique_ptr<UdpSocket>(
-            new UdpSocket(receive_address_.c_str(), receive_port_));
+    if (receive_address_.empty()) {
+        throw dds::core::IllegalOperationError(
+                "receive_address must be set");
+    }
+    // Also rejects a missing receive_port
+    if (receive_port_ <= 0 || receive_port_ > 65535) {
+        throw dds::core::IllegalOperationError(
+                "receive_port must be between 1 and 65535");
+    }
+    if (receive_queue_size <= 0) {
+        throw dds::core::IllegalOperationError(
+                "receive_queue_size must be greater than 0");
+    }
+    if (max_datagram_size_ <= 0 || max_datagram_size_ > MAX_UDP_DATAGRAM_SIZE) {
+        throw dds::core::IllegalOperationError(
+                "max_datagram_size must be between 1 and "
+                + std::to_string(MAX_UDP_DATAGRAM_SIZE));
+    }
+
+    if (receive_batch_size_ <= 0) {
+        throw dds::core::IllegalOperationError(
+                "receive_batch_size must be greater than 0");
+    }
+    if (receive_socket_count <= 0) {
+        throw dds::core::IllegalOperationError(
+                "receive_socket_count must be greater than 0");
+    }
+
+    /**
+     * Multicast datagrams are delivered to every socket of a SO_REUSEPORT
+     * group instead of being balanced between them, so each sample would be
+     * received receive_socket_count times.
+     */
+    if (!multicast_group.empty() && receive_socket_count > 1) {
+        throw dds::core::IllegalOperationError(
+                "multicast_group can only be used with receive_socket_count 1");
+    }
+
+    /**
+     * Without fragmentation a sample is a datagram. With it, samples can be
+     * up to max_sample_size, but the ring slots only allocate memory for
+     * them when they are actually received.
+     */
+    size_t max_packet_size = fragmentation ? max_sample_size
+                                           : max_datagram_size_;
+
+    // All the sockets are created before starting any thread, so a failure
+    // doesn't leave threads running
+    for (int i = 0; i < receive_socket_count; ++i) {
+        std::unique_ptr<ReceiveChannel> channel(new ReceiveChannel);
+        channel->socket.reset(new UdpSocket(
+                receive_address_.c_str(),
+                receive_port_,
+                receive_batch_size_,
+                max_datagram_size_,
+                receive_socket_count > 1));
+        if (receive_socket_buffer_size > 0) {
+            channel->socket->set_receive_buffer_size(
+                    receive_socket_buffer_size);
+        }
+        if (kernel_timestamps) {
+            channel->socket->enable_kernel_timestamps();
+        }
+        if (!multicast_group.empty()) {
+            channel->socket->join_multicast_group(
+                    multicast_group.c_str(),
+                    multicast_interface.c_str());
+        }
+        channel->received_packets.reset(new PacketRingBuffer(
+                receive_queue_size,
+                max_packet_size,
+                max_datagram_size_));
+        if (fragmentation) {
+            channel->reassembler.reset(new FragmentReassembler(
+                    max_sample_size,
+                    reassembly_memory_cap,
+                    std::chrono::milliseconds(reassembly_timeout)));
+        }
+        channels_.push_back(std::move(channel));
+    }
 
-    socketreader_thread_ =
-            std::thread(&SocketStreamReader::socket_reading_thread, this);
+    for (auto &channel : channels_) {
+        channel->thread = std::thread(
+                &SocketStreamReader::socket_reading_thread,
+                this,
+                channel.get());
+    }
 }
 
 void SocketStreamReader::take(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
 {
-    take_buffer_.clear();
-    {
-        std::unique_lock<std::mutex> lock(buffer_mutex_);
-        if (received_buffers_.empty()) {
-            // No data available
-            samples.clear();
-            infos.clear();
-            return;
+    samples.clear();
+    infos.clear();
+
+    /**
+     * Drain every packet available in the rings into a single batch. The
+     * packets are deserialized straight from their ring slot, which is
+     * released right after, into a sample from the pool.
+     */
+    int64_t now = UdpSocket::current_time_ns();
+    DDS_SampleInfo native_info = DDS_SAMPLEINFO_DEFAULT;
+    native_info.valid_data = DDS_BOOLEAN_TRUE;
+    for (auto &channel : channels_) {
+        PacketRingBuffer *received_packets = channel->received_packets.get();
+        const std::vector<char> *packet = nullptr;
+        while ((packet = received_packets->front()) != nullptr) {
+            std::unique_ptr<DynamicData> sample = get_pooled_sample();
+            try {
+                rti::core::xtypes::from_cdr_buffer(*sample, *packet);
+            } catch (const std::exception &) {
+                // A malformed packet is skipped, so it can't block the ring
+                ++malformed_count_;
+                received_packets->pop();
+                std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+                sample_pool_.push_back(std::move(sample));
+                continue;
+            }
+
+            // The receive time is the only timing information we have
+            int64_t timestamp = received_packets->front_timestamp();
+            native_info.source_timestamp = to_dds_time(timestamp);
+            native_info.reception_timestamp = native_info.source_timestamp;
+            std::unique_ptr<dds::sub::SampleInfo> info = get_pooled_info();
+            (*info)->native() = native_info;
+            if (latency_statistics_period_ > 0) {
+                latency_histogram_.record(now - timestamp);
+            }
+
+            received_packets->pop();
+            samples.push_back(sample.release());
+            infos.push_back(info.release());
         }
-        take_buffer_ = std::move(received_buffers_.front());
-        received_buffers_.pop();
     }
 
-    dds::core::xtypes::DynamicData deserialized_sample(*adapter_type_);
-    rti::core::xtypes::from_cdr_buffer(deserialized_sample, take_buffer_);
-    
-    samples.resize(1);
-    infos.resize(1);
-    
-    std::unique_ptr<DynamicData> sample(new DynamicData(*adapter_type_));
-    *sample = deserialized_sample;
-    samples[0] = sample.release();
+    if (latency_statistics_period_ > 0) {
+        report_latency_statistics(now);
+    }
 
     return;
 }
 
+std::unique_ptr<DynamicData> SocketStreamReader::get_pooled_sample()
+{
+    {
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        if (!sample_pool_.empty()) {
+            std::unique_ptr<DynamicData> sample =
+                    std::move(sample_pool_.back());
+            sample_pool_.pop_back();
+            return sample;
+        }
+    }
+
+    // The pool grows up to the max number of samples loaned at once
+    return std::unique_ptr<DynamicData>(new DynamicData(*adapter_type_));
+}
+
+std::unique_ptr<dds::sub::SampleInfo> SocketStreamReader::get_pooled_info()
+{
+    {
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        if (!info_pool_.empty()) {
+            std::unique_ptr<dds::sub::SampleInfo> info =
+                    std::move(info_pool_.back());
+            info_pool_.pop_back();
+            return info;
+        }
+    }
+
+    return std::unique_ptr<dds::sub::SampleInfo>(new dds::sub::SampleInfo);
+}
+
+void SocketStreamReader::report_latency_statistics(int64_t now)
+{
+    if (now - last_statistics_time_ < latency_statistics_period_) {
+        return;
+    }
+    last_statistics_time_ = now;
+    if (latency_histogram_.count() == 0) {
+        return;
+    }
+
+    Logger::instance().local(
+            "SocketStreamReader " + stream_info_.stream_name()
+            + ": socket to take() latency: " + latency_histogram_.summary());
+    latency_histogram_.reset();
+}
+
 void SocketStreamReader::return_loan(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
 {
-    for (int i = 0; i < samples.size(); ++i) {
-        delete samples[i];
-        delete infos[i];
+    {
+        // The samples go back to the pool to be reused by the next take()
+        std::lock_guard<std::mutex> lock(sample_pool_mutex_);
+        for (auto sample : samples) {
+            sample_pool_.emplace_back(sample);
+        }
+        for (auto info : infos) {
+            info_pool_.emplace_back(info);
+        }
     }
     samples.clear();
     infos.clear();
@@ -140,7 +373,39 @@ void SocketStreamReader::return_loan(
 void SocketStreamReader::shutdown_socket_reader_thread()
 {
     stop_thread_ = true;
-    socketreader_thread_.join();
+    for (auto &channel : channels_) {
+        channel->socket->unblock();
+    }
+
+    uint64_t dropped_packets = 0;
+    uint64_t dropped_samples = 0;
+    for (auto &channel : channels_) {
+        channel->thread.join();
+        dropped_packets += channel->received_packets->dropped_count();
+        if (channel->reassembler) {
+            dropped_samples += channel->reassembler->dropped_count();
+        }
+    }
+    socket_connection_->dispose_discovery_stream(stream_info_);
+
+    if (dropped_packets > 0) {
+        Logger::instance().local(
+                "SocketStreamReader " + stream_info_.stream_name()
+                + ": dropped " + std::to_string(dropped_packets)
+                + " packets because the receive queue was full");
+    }
+    if (dropped_samples > 0) {
+        Logger::instance().local(
+                "SocketStreamReader " + stream_info_.stream_name()
+                + ": dropped " + std::to_string(dropped_samples)
+                + " incomplete or invalid fragmented samples");
+    }
+    if (malformed_count_ > 0) {
+        Logger::instance().local(
+                "SocketStreamReader " + stream_info_.stream_name()
+                + ": dropped " + std::to_string(malformed_count_)
+                + " packets that could not be deserialized");
+    }
 }
 
 SocketStreamReader::~SocketStreamReader()
@@ -13,11 +13,16 @@
 #ifndef SOCKETSTREAMREADER_HPP
 #define SOCKETSTREAMREADER_HPP
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <thread>
-#include <queue>
 
+#include "Fragmentation.hpp"
+#include "LatencyHistogram.hpp"
+#include "PacketRingBuffer.hpp"
 #include "SocketConnection.hpp"
 #include "UdpSocket.hpp"
 
@@ -27,6 +32,25 @@
 #define BUFFER_MAX_SIZE 1024
 #define RECEIVE_ADDRESS_STRING "receive_address"
 #define RECEIVE_PORT_STRING "receive_port"
+#define RECEIVE_BATCH_SIZE_STRING "receive_batch_size"
+#define RECEIVE_BATCH_SIZE_DEFAULT 32
+#define RECEIVE_QUEUE_SIZE_STRING "receive_queue_size"
+#define RECEIVE_QUEUE_SIZE_DEFAULT 1024
+#define MAX_DATAGRAM_SIZE_STRING "max_datagram_size"
+#define RECEIVE_SOCKET_BUFFER_SIZE_STRING "receive_socket_buffer_size"
+#define FRAGMENTATION_STRING "fragmentation"
+#define MAX_SAMPLE_SIZE_STRING "max_sample_size"
+#define MAX_SAMPLE_SIZE_DEFAULT (1024 * 1024)
+#define REASSEMBLY_TIMEOUT_STRING "reassembly_timeout_ms"
+#define REASSEMBLY_TIMEOUT_DEFAULT 1000
+#define REASSEMBLY_MEMORY_CAP_STRING "reassembly_memory_cap"
+#define REASSEMBLY_MEMORY_CAP_DEFAULT (16 * 1024 * 1024)
+#define RECEIVE_SOCKET_COUNT_STRING "receive_socket_count"
+#define MULTICAST_GROUP_STRING "multicast_group"
+#define MULTICAST_INTERFACE_STRING "multicast_interface"
+#define MULTICAST_INTERFACE_DEFAULT "0.0.0.0"
+#define KERNEL_TIMESTAMPS_STRING "kernel_timestamps"
+#define LATENCY_STATISTICS_PERIOD_STRING "latency_statistics_period_ms"
 
 /**
  * @brief StreamReader implementation for UDP socket input in RTI Routing Service.
@@ -35,9 +59,17 @@
  * that receives data from a UDP socket and makes it available to RTI Routing Service as DynamicData samples.
  * 
  * This class manages a background thread to continuously read UDP packets from a specified address and port,
- * buffering received data for consumption by the Routing Service. It supports thread-safe queuing of incoming
- * data, loaning and returning DynamicData samples, and clean shutdown of the reading thread.
+ * buffering received data for consumption by the Routing Service. Incoming packets are stored in a
+ * preallocated lock-free ring that take() drains into a single batch of DynamicData samples.
  *
+ * With receive_socket_count greater than 1, the reader binds that many sockets to the same
+ * address and port with SO_REUSEPORT. Each socket has its own thread, ring and reassembler, so
+ * the kernel can spread the incoming flows across cores and take() drains all the rings.
+ *
+ * The SampleInfo of each sample has the time its datagram was received, from the kernel when
+ * kernel_timestamps is enabled, as source and reception timestamp. With
+ * latency_statistics_period_ms, the time between reception and take() is kept in a
+ * LatencyHistogram that is logged with that period.
  */
 
 class SocketStreamReader : public rti::routing::adapter::DynamicDataStreamReader {
@@ -62,26 +94,65 @@ public:
 
 private:
     /**
-     * @brief Function used by socketreader_thread_ to read samples from the
-     * socket.
+     * @brief A receive socket with the thread that reads from it and the
+     * queue that thread fills. Each ring has a single producer, its thread,
+     * and a single consumer, take().
+     */
+    struct ReceiveChannel {
+        std::unique_ptr<UdpSocket> socket;
+        std::unique_ptr<PacketRingBuffer> received_packets;
+        // Only set when fragmentation is enabled
+        std::unique_ptr<FragmentReassembler> reassembler;
+        std::thread thread;
+    };
+
+    /**
+     * @brief Function used by the thread of each ReceiveChannel to read
+     * samples from its socket.
+     */
+    void socket_reading_thread(ReceiveChannel *channel);
+
+    /**
+     * @brief Returns a sample from sample_pool_, or a new one if the pool is
+     * empty.
      */
-    void socket_reading_thread();
+    std::unique_ptr<dds::core::xtypes::DynamicData> get_pooled_sample();
+
+    /**
+     * @brief Returns a SampleInfo from info_pool_, or a new one if the pool is
+     * empty.
+     */
+    std::unique_ptr<dds::sub::SampleInfo> get_pooled_info();
+
+    /**
+     * @brief Logs and resets the latency histogram if the statistics period
+     * has elapsed. Called from take().
+     */
+    void report_latency_statistics(int64_t now);
 
     SocketConnection *socket_connection_;
     rti::routing::adapter::StreamReaderListener *reader_listener_;
 
-    std::unique_ptr<UdpSocket> socket;
-
-    std::thread socketreader_thread_;
-    bool stop_thread_;
+    std::vector<std::unique_ptr<ReceiveChannel>> channels_;
+    std::atomic<bool> stop_thread_;
 
     std::ifstream input_socket_stream_;
     std::string receive_address_;
     int receive_port_;
-    char received_buffer_[BUFFER_MAX_SIZE];
-    std::queue<std::vector<char>> received_buffers_;
-    std::mutex buffer_mutex_;
-    std::vector<char> take_buffer_;
+    int receive_batch_size_;
+    int max_datagram_size_;
+    // Samples returned by return_loan(), reused by take()
+    std::vector<std::unique_ptr<dds::core::xtypes::DynamicData>> sample_pool_;
+    std::vector<std::unique_ptr<dds::sub::SampleInfo>> info_pool_;
+    std::mutex sample_pool_mutex_;
+
+    // Packets that could not be deserialized, only updated from take()
+    uint64_t malformed_count_;
+
+    // Socket to take() latency, only used from take()
+    LatencyHistogram latency_histogram_;
+    int64_t latency_statistics_period_;
+    int64_t last_statistics_time_;
 
     rti::routing::StreamInfo stream_info_;
     dds::core::xtypes::DynamicType *adapter_type_;
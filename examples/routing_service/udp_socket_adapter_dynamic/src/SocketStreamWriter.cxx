@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <random>
 #include <sstream>
 #include <thread>
 #include <chrono>
@@ -45,7 +46,11 @@ SocketStreamWriter::SocketStreamWriter(
         const StreamInfo &info,
         const PropertySet &properties
         )
-        : stream_info_(info.stream_name(), info.type_info().type_name())
+        : stream_info_(info.stream_name(), info.type_info().type_name()),
+          max_datagram_size_(MAX_UDP_DATAGRAM_SIZE),
+          fragmentation_(false),
+          // A restarted writer doesn't reuse the ids of its last samples
+          next_message_id_(std::random_device()())
 {
 
     socket_connection_ = connection;
@@ -70,32 +75,145 @@ SocketStreamWriter::SocketStreamWriter(
 		{
 			dest_port_ = std::stoi(property.second);
 		}		
+        else if (property.first == MAX_DATAGRAM_SIZE_STRING) {
+            max_datagram_size_ = std::stoi(property.second);
+        } else if (property.first == FRAGMENTATION_STRING) {
+            fragmentation_ =
+                    property.second == "true" || property.second == "1";
+        }
 	}
 
+    if (max_datagram_size_ <= FRAGMENT_HEADER_SIZE
+        || max_datagram_size_ > MAX_UDP_DATAGRAM_SIZE) {
+        throw dds::core::IllegalOperationError(
+                "max_datagram_size must be between "
+                + std::to_string(FRAGMENT_HEADER_SIZE + 1) + " and "
+                + std::to_string(MAX_UDP_DATAGRAM_SIZE));
+    }
+
 	socket = std::unique_ptr<UdpSocket>(new UdpSocket(
 		send_address_.c_str(),
 		send_port_));
+
+    // The destination is resolved once, not every time we send a sample
+    socket->set_destination(dest_address_.c_str(), dest_port_);
 }
 
 int SocketStreamWriter::write(
         const std::vector<dds::core::xtypes::DynamicData *> &samples,
         const std::vector<dds::sub::SampleInfo *> &infos)        
 {
-    size_t len = 0;
-    for (const auto sample : samples) {
-        serialization_buffer_.clear();
-        rti::core::xtypes::to_cdr_buffer(serialization_buffer_, *sample);
-	 // Send the serialized data
-        len = socket->send_data(
-            serialization_buffer_.data(),
-            serialization_buffer_.size(),
-            dest_address_.c_str(),
-            dest_port_);
+    /**
+     * Serialize the whole batch first. Each sample has its own buffer in
+     * serialization_buffers_, which keeps its capacity between calls, so
+     * after the first batches serializing doesn't allocate memory.
+     */
+    if (serialization_buffers_.size() < samples.size()) {
+        serialization_buffers_.resize(samples.size());
+    }
+    for (size_t i = 0; i < samples.size(); ++i) {
+        serialization_buffers_[i].clear();
+        rti::core::xtypes::to_cdr_buffer(
+                serialization_buffers_[i],
+                *samples[i]);
+    }
+
+    if (fragmentation_) {
+        fragment_samples(samples.size());
+    } else {
+        send_buffers_.clear();
+        send_lengths_.clear();
+        for (size_t i = 0; i < samples.size(); ++i) {
+            // The receiver would only get part of a sample this large
+            if (serialization_buffers_[i].size()
+                > static_cast<size_t>(max_datagram_size_)) {
+                Logger::instance().local(
+                        "Dropping sample larger than max_datagram_size, "
+                        "enable fragmentation to send it");
+                continue;
+            }
+            send_buffers_.push_back(serialization_buffers_[i].data());
+            send_lengths_.push_back(
+                    static_cast<int>(serialization_buffers_[i].size()));
+        }
+    }
+
+    // Send the serialized data, with a single system call when possible
+    int sent_count = socket->send_batch(
+            send_buffers_.data(),
+            send_lengths_.data(),
+            static_cast<int>(send_buffers_.size()));
+
+    // With fragmentation we only know that all the fragments were sent
+    if (fragmentation_) {
+        return sent_count == static_cast<int>(send_buffers_.size())
+                ? static_cast<int>(samples.size())
+                : 0;
+    }
+    return sent_count;
+}
+
+void SocketStreamWriter::fragment_samples(size_t sample_count)
+{
+    size_t max_payload_size = max_datagram_size_ - FRAGMENT_HEADER_SIZE;
+
+    fragment_buffer_.clear();
+    fragment_offsets_.clear();
+    send_lengths_.clear();
+    for (size_t i = 0; i < sample_count; ++i) {
+        const std::vector<char> &serialized = serialization_buffers_[i];
+        size_t fragment_count =
+                (serialized.size() + max_payload_size - 1) / max_payload_size;
+        if (fragment_count == 0) {
+            fragment_count = 1;
+        }
+        if (fragment_count > UINT16_MAX) {
+            Logger::instance().local(
+                    "Dropping sample that needs too many fragments");
+            continue;
+        }
+
+        FragmentHeader header;
+        header.magic = FRAGMENT_HEADER_MAGIC;
+        header.message_id = next_message_id_++;
+        header.fragment_count = static_cast<uint16_t>(fragment_count);
+        header.total_size = static_cast<uint32_t>(serialized.size());
+        for (size_t index = 0; index < fragment_count; ++index) {
+            size_t payload_offset = index * max_payload_size;
+            size_t payload_size = std::min(
+                    max_payload_size,
+                    serialized.size() - payload_offset);
+            header.fragment_index = static_cast<uint16_t>(index);
+
+            size_t offset = fragment_buffer_.size();
+            fragment_buffer_.resize(
+                    offset + FRAGMENT_HEADER_SIZE + payload_size);
+            serialize_fragment_header(header, &fragment_buffer_[offset]);
+            if (payload_size > 0) {
+                memcpy(&fragment_buffer_[offset + FRAGMENT_HEADER_SIZE],
+                       &serialized[payload_offset],
+                       payload_size);
+            }
+            fragment_offsets_.push_back(offset);
+            send_lengths_.push_back(
+                    static_cast<int>(FRAGMENT_HEADER_SIZE + payload_size));
+        }
+    }
+
+    // fragment_buffer_ may have grown while fragmenting, so we take the
+    // pointers to the fragments once it's complete
+    send_buffers_.resize(fragment_offsets_.size());
+    for (size_t i = 0; i < fragment_offsets_.size(); ++i) {
+        send_buffers_[i] = &fragment_buffer_[fragment_offsets_[i]];
     }
-	
-    return len;
 }
 
 SocketStreamWriter::~SocketStreamWriter()
 {
+    if (socket->unsent_count() > 0) {
+        Logger::instance().local(
+                "SocketStreamWriter " + stream_info_.stream_name()
+                + ": could not send " + std::to_string(socket->unsent_count())
+                + " datagrams");
+    }
 }
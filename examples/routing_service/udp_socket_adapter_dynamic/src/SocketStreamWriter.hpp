@@ -18,6 +18,7 @@
 #include <thread>
 #include <cstring>
 
+#include "Fragmentation.hpp"
 #include "SocketConnection.hpp"
 #include "UdpSocket.hpp"
 
@@ -29,6 +30,8 @@
 #define SEND_PORT_STRING "send_port"
 #define DEST_ADDRESS_STRING "dest_address"
 #define DEST_PORT_STRING "dest_port"
+#define MAX_DATAGRAM_SIZE_STRING "max_datagram_size"
+#define FRAGMENTATION_STRING "fragmentation"
 
 /**
  * @brief StreamWriter implementation for UDP socket output in RTI Routing Service.
@@ -38,6 +41,8 @@
  *
  * This class is responsible for serializing DynamicData samples received from Routing Service
  * and transmitting them as UDP packets to a specified destination address and port.
+ * All the samples passed to a write() call are sent as a batch. When fragmentation
+ * is enabled, samples larger than max_datagram_size are split in several datagrams.
  * It manages socket creation, serialization buffers, and the configuration of destination
  * parameters via properties.
  *
@@ -59,9 +64,19 @@ public:
 	
 
 private:
+    /**
+     * @brief Splits the serialized samples in fragments with a
+     * FragmentHeader, stored in fragment_buffer_, and fills send_buffers_ and
+     * send_lengths_ with them.
+     */
+    void fragment_samples(size_t sample_count);
 
     SocketConnection *socket_connection_;
-    std::vector<char> serialization_buffer_;
+    // One serialization buffer per sample of the batch, reused between writes
+    std::vector<std::vector<char>> serialization_buffers_;
+    std::vector<const char *> send_buffers_;
+    std::vector<int> send_lengths_;
+
     std::unique_ptr<UdpSocket> socket;
 
     int send_port_;
@@ -71,6 +86,14 @@ private:
     std::string dest_address_;
     rti::routing::StreamInfo stream_info_;
     dds::core::xtypes::DynamicType *adapter_type_;
+
+    int max_datagram_size_;
+    bool fragmentation_;
+    // Starts at a random value
+    uint32_t next_message_id_;
+    // Fragments of the batch, with their offsets in fragment_buffer_
+    std::vector<char> fragment_buffer_;
+    std::vector<size_t> fragment_offsets_;
 };
 
 #endif
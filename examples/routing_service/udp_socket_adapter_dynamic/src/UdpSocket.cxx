@@ -14,8 +14,26 @@
 
 #include <rti/core/Exception.hpp>
 
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <thread>
 
-UdpSocket::UdpSocket(const char *ip, int port)
+
+UdpSocket::UdpSocket(
+        const char *ip,
+        int port,
+        int batch_size,
+        int max_datagram_size,
+        bool reuse_port)
+        : batch_size_(batch_size),
+          max_datagram_size_(max_datagram_size),
+          batch_buffer_(batch_size * max_datagram_size),
+          datagram_sizes_(batch_size),
+          datagram_timestamps_(batch_size),
+          datagram_sources_(batch_size),
+          unblocked_(false),
+          unsent_count_(0)
 {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -41,8 +59,32 @@ UdpSocket::UdpSocket(const char *ip, int port)
     fcntl(sockfd, F_SETFL, O_NONBLOCK);
 #endif
 
-    // Bind the socket
+    // Bind the socket, sharing the port with other sockets if requested
+    if (reuse_port) {
+        set_reuse_port();
+    }
     bind_socket(ip, port);
+
+#ifdef __linux__
+    shutdown_fd_ = eventfd(0, EFD_NONBLOCK);
+    if (shutdown_fd_ < 0) {
+        close(sockfd);
+        throw dds::core::IllegalOperationError("eventfd creation failed");
+    }
+
+    // Every message of the batch receives into its own slot of batch_buffer_
+    control_buffer_size_ = 0;
+    messages_.resize(batch_size_);
+    iovecs_.resize(batch_size_);
+    for (int i = 0; i < batch_size_; ++i) {
+        iovecs_[i].iov_base = &batch_buffer_[i * max_datagram_size_];
+        iovecs_[i].iov_len = max_datagram_size_;
+        memset(&messages_[i], 0, sizeof(messages_[i]));
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+        messages_[i].msg_hdr.msg_name = &datagram_sources_[i];
+    }
+#endif
 }
 
 UdpSocket::~UdpSocket()
@@ -53,6 +95,9 @@ UdpSocket::~UdpSocket()
 #else
     close(sockfd);
 #endif
+#ifdef __linux__
+    close(shutdown_fd_);
+#endif
 }
 
 void UdpSocket::init_socket()
@@ -62,6 +107,25 @@ void UdpSocket::init_socket()
     }
 }
 
+void UdpSocket::set_reuse_port()
+{
+#ifdef SO_REUSEPORT
+    int enable = 1;
+    if (setsockopt(
+                sockfd,
+                SOL_SOCKET,
+                SO_REUSEPORT,
+                (const char *) &enable,
+                sizeof(enable))
+        != 0) {
+        throw dds::core::IllegalOperationError("Setting SO_REUSEPORT failed");
+    }
+#else
+    throw dds::core::IllegalOperationError(
+            "SO_REUSEPORT is not supported on this platform");
+#endif
+}
+
 void UdpSocket::bind_socket(const char *ip, int port)
 {
     server_addr.sin_family = AF_INET;
@@ -99,6 +163,183 @@ void UdpSocket::receive_data(
     return;
 }
 
+void UdpSocket::set_receive_buffer_size(int size)
+{
+    if (setsockopt(
+                sockfd,
+                SOL_SOCKET,
+                SO_RCVBUF,
+                (const char *) &size,
+                sizeof(size))
+        != 0) {
+        throw dds::core::IllegalOperationError("Setting SO_RCVBUF failed");
+    }
+}
+
+void UdpSocket::join_multicast_group(
+        const char *group_addr,
+        const char *interface_addr)
+{
+    struct ip_mreq membership;
+    memset(&membership, 0, sizeof(membership));
+    if (inet_pton(AF_INET, group_addr, &(membership.imr_multiaddr)) != 1) {
+        throw dds::core::IllegalOperationError(
+                std::string("Invalid multicast group address: ") + group_addr);
+    }
+    if (inet_pton(AF_INET, interface_addr, &(membership.imr_interface))
+        != 1) {
+        throw dds::core::IllegalOperationError(
+                std::string("Invalid multicast interface address: ")
+                + interface_addr);
+    }
+
+    if (setsockopt(
+                sockfd,
+                IPPROTO_IP,
+                IP_ADD_MEMBERSHIP,
+                (const char *) &membership,
+                sizeof(membership))
+        != 0) {
+        throw dds::core::IllegalOperationError(
+                std::string("Joining multicast group failed: ") + group_addr);
+    }
+}
+
+void UdpSocket::enable_kernel_timestamps()
+{
+#ifdef __linux__
+    int enable = 1;
+    if (setsockopt(
+                sockfd,
+                SOL_SOCKET,
+                SO_TIMESTAMPNS,
+                &enable,
+                sizeof(enable))
+        != 0) {
+        throw dds::core::IllegalOperationError(
+                "Setting SO_TIMESTAMPNS failed");
+    }
+
+    // Each message gets room for its timestamp control message
+    control_buffer_size_ = CMSG_SPACE(sizeof(struct timespec));
+    control_buffers_.assign(batch_size_ * control_buffer_size_, 0);
+    for (int i = 0; i < batch_size_; ++i) {
+        messages_[i].msg_hdr.msg_control =
+                &control_buffers_[i * control_buffer_size_];
+    }
+#endif
+}
+
+int64_t UdpSocket::current_time_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+}
+
+int UdpSocket::receive_batch()
+{
+#ifdef __linux__
+    struct pollfd fds[2];
+    fds[0].fd = sockfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = shutdown_fd_;
+    fds[1].events = POLLIN;
+
+    // Interrupted or failed waits are reported as an empty batch
+    if (poll(fds, 2, -1) <= 0 || (fds[1].revents & POLLIN)) {
+        return 0;
+    }
+
+    // The kernel overwrites the address and control lengths with the
+    // lengths it used
+    for (int i = 0; i < batch_size_; ++i) {
+        messages_[i].msg_hdr.msg_namelen = sizeof(datagram_sources_[i]);
+        messages_[i].msg_hdr.msg_controllen = control_buffer_size_;
+    }
+
+    int count = recvmmsg(
+            sockfd,
+            messages_.data(),
+            batch_size_,
+            MSG_DONTWAIT,
+            nullptr);
+    if (count <= 0) {
+        return 0;
+    }
+
+    // Datagrams without a kernel timestamp get the time they were read
+    int64_t read_time = current_time_ns();
+    for (int i = 0; i < count; ++i) {
+        datagram_sizes_[i] = (messages_[i].msg_hdr.msg_flags & MSG_TRUNC)
+                ? 0
+                : messages_[i].msg_len;
+        datagram_timestamps_[i] = read_time;
+        if (control_buffer_size_ == 0) {
+            continue;
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&messages_[i].msg_hdr);
+             cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(&messages_[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET
+                && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec kernel_time;
+                memcpy(&kernel_time, CMSG_DATA(cmsg), sizeof(kernel_time));
+                datagram_timestamps_[i] =
+                        kernel_time.tv_sec * 1000000000LL + kernel_time.tv_nsec;
+            }
+        }
+    }
+    return count;
+#else
+    while (!unblocked_) {
+        receive_data(
+                batch_buffer_.data(),
+                &datagram_sizes_[0],
+                max_datagram_size_);
+        if (datagram_sizes_[0] > 0) {
+            datagram_timestamps_[0] = current_time_ns();
+            datagram_sources_[0] = client_addr;
+            return 1;
+        }
+        // Sleep for a small period of time to avoid busy waiting
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return 0;
+#endif
+}
+
+const char *UdpSocket::datagram(int index) const
+{
+    return &batch_buffer_[index * max_datagram_size_];
+}
+
+int UdpSocket::datagram_size(int index) const
+{
+    return datagram_sizes_[index];
+}
+
+int64_t UdpSocket::datagram_timestamp(int index) const
+{
+    return datagram_timestamps_[index];
+}
+
+const struct sockaddr_in &UdpSocket::datagram_source(int index) const
+{
+    return datagram_sources_[index];
+}
+
+void UdpSocket::unblock()
+{
+    unblocked_ = true;
+#ifdef __linux__
+    uint64_t value = 1;
+    if (write(shutdown_fd_, &value, sizeof(value)) < 0) {
+        std::cerr << "Error unblocking the socket receive thread\n";
+    }
+#endif
+}
+
 int UdpSocket::send_data(char* tx_buffer, int tx_length, const char* destAddr, int destPort)
 {
     sockaddr_in dest_addr;
@@ -108,4 +349,118 @@ int UdpSocket::send_data(char* tx_buffer, int tx_length, const char* destAddr, i
 
     size_t length = sendto(sockfd, tx_buffer, tx_length, 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
     return (int)length;
-}
\ No newline at end of file
+}
+
+void UdpSocket::set_destination(const char *dest_addr, int dest_port)
+{
+    memset(&dest_addr_, 0, sizeof(dest_addr_));
+    dest_addr_.sin_family = AF_INET;
+    dest_addr_.sin_port = htons(dest_port);
+    if (inet_pton(AF_INET, dest_addr, &(dest_addr_.sin_addr)) != 1) {
+        throw dds::core::IllegalOperationError(
+                std::string("Invalid destination address: ") + dest_addr);
+    }
+}
+
+int UdpSocket::send_batch(
+        const char *const *buffers,
+        const int *lengths,
+        int count)
+{
+#ifdef __linux__
+    // The message headers are reused between calls, only growing if needed
+    if (send_messages_.size() < (size_t) count) {
+        send_messages_.resize(count);
+        send_iovecs_.resize(count);
+    }
+    for (int i = 0; i < count; ++i) {
+        send_iovecs_[i].iov_base = const_cast<char *>(buffers[i]);
+        send_iovecs_[i].iov_len = lengths[i];
+        memset(&send_messages_[i], 0, sizeof(send_messages_[i]));
+        send_messages_[i].msg_hdr.msg_name = &dest_addr_;
+        send_messages_[i].msg_hdr.msg_namelen = sizeof(dest_addr_);
+        send_messages_[i].msg_hdr.msg_iov = &send_iovecs_[i];
+        send_messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /*
+     * sendmmsg may send fewer messages than requested, so we loop. It only
+     * fails when the first message can't be sent, which is then skipped.
+     */
+    int sent_count = 0;
+    int next = 0;
+    while (next < count) {
+        int sent = sendmmsg(sockfd, &send_messages_[next], count - next, 0);
+        if (sent > 0) {
+            sent_count += sent;
+            next += sent;
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (!send_would_block()) {
+            ++unsent_count_;
+            ++next;
+        } else if (!wait_writable()) {
+            unsent_count_ += count - next;
+            break;
+        }
+    }
+    return sent_count;
+#else
+    int sent_count = 0;
+    for (int i = 0; i < count; ++i) {
+        while (sendto(sockfd,
+                      buffers[i],
+                      lengths[i],
+                      0,
+                      (const struct sockaddr *) &dest_addr_,
+                      sizeof(dest_addr_))
+               < 0) {
+            if (!send_would_block()) {
+                ++unsent_count_;
+                break;
+            }
+            if (!wait_writable()) {
+                unsent_count_ += count - i;
+                return sent_count;
+            }
+        }
+        ++sent_count;
+    }
+    return sent_count;
+#endif
+}
+
+uint64_t UdpSocket::unsent_count() const
+{
+    return unsent_count_;
+}
+
+bool UdpSocket::wait_writable()
+{
+#ifdef _WIN32
+    WSAPOLLFD fd;
+    fd.fd = sockfd;
+    fd.events = POLLWRNORM;
+    fd.revents = 0;
+    return WSAPoll(&fd, 1, SEND_WAIT_TIMEOUT_MS) > 0;
+#else
+    struct pollfd fd;
+    fd.fd = sockfd;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+    int result = 0;
+    do {
+        result = poll(&fd, 1, SEND_WAIT_TIMEOUT_MS);
+    } while (result < 0 && errno == EINTR);
+    return result > 0;
+#endif
+}
+
+bool UdpSocket::send_would_block()
+{
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
@@ -23,14 +23,26 @@
     #include <unistd.h>
     #include <fcntl.h>
     #include <cstring>
+    #include <poll.h>
+#endif
+#ifdef __linux__
+    #include <sys/eventfd.h>
 #endif
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #ifdef _WIN32
     #pragma comment(lib, "ws2_32.lib")
 #endif
 
+// Max payload of a UDP datagram over IPv4
+#define MAX_UDP_DATAGRAM_SIZE 65507
+// Max time send_batch() waits for room in the send buffer of the socket
+#define SEND_WAIT_TIMEOUT_MS 1000
+
 /**
  * @brief Utility class for UDP socket communication in the RTI Routing Service UDP Socket Adapter.
  *
@@ -43,23 +55,130 @@
  * ensures non-blocking operation for efficient integration with multi-threaded applications.
  * It provides methods for receiving data from any UDP client and for sending data to a
  * specified destination address and port. 
+ *
+ * The receive_batch() method blocks until datagrams arrive or until
+ * unblock() is called. On Linux it waits with poll() on the socket and on a
+ * shutdown eventfd, and then reads up to batch_size datagrams with a single
+ * recvmmsg() call. On other platforms it falls back to polling the
+ * non-blocking socket.
+ *
+ * Every received datagram has a timestamp, in nanoseconds since the epoch.
+ * With enable_kernel_timestamps() on Linux it's the time the kernel received
+ * the datagram (SO_TIMESTAMPNS), otherwise the time receive_batch() read it.
+ *
+ * When reuse_port is set, the socket is bound with SO_REUSEPORT, so several
+ * UdpSocket objects can receive on the same address and port, each one from
+ * its own thread, and the kernel spreads the incoming flows between them.
+ * This is only available on platforms that define SO_REUSEPORT. The socket
+ * can also receive from a multicast group with join_multicast_group().
+ *
+ * For sending, the destination can be resolved once with set_destination()
+ * and then send_batch() sends several datagrams to it, with a single
+ * sendmmsg() call on Linux. Since the socket is non-blocking, send_batch()
+ * waits with poll() when the send buffer is full. The datagrams it can't send
+ * are counted in unsent_count().
  */
 
 class UdpSocket {
 public:
-    UdpSocket(const char* ip, int port);
+    UdpSocket(
+            const char* ip,
+            int port,
+            int batch_size = 1,
+            int max_datagram_size = 1024,
+            bool reuse_port = false);
     ~UdpSocket();
     void receive_data(
             char* received_buffer,
             int* received_bytes,
             int size_of_original_buffer);
 
+    /**
+     * @brief Sets the size of the kernel receive buffer (SO_RCVBUF), so bursts
+     * of large datagrams are not dropped before they are read.
+     */
+    void set_receive_buffer_size(int size);
+
+    /**
+     * @brief Joins the multicast group_addr (IP_ADD_MEMBERSHIP) on the
+     * interface with address interface_addr, or on the default interface if
+     * interface_addr is 0.0.0.0. Throws if any address is not valid or the
+     * join fails.
+     */
+    void join_multicast_group(
+            const char* group_addr,
+            const char* interface_addr);
+
+    /**
+     * @brief Blocks until at least one datagram is received or unblock() is
+     * called. The received datagrams are available through datagram() and
+     * datagram_size() until the next call. Datagrams larger than
+     * max_datagram_size are truncated, their size is reported as 0.
+     *
+     * @return the number of datagrams received, 0 if unblocked or on error.
+     */
+    int receive_batch();
+
+    const char* datagram(int index) const;
+
+    int datagram_size(int index) const;
+
+    int64_t datagram_timestamp(int index) const;
+
+    /**
+     * @brief Address and port, in network byte order, of the sender of a
+     * received datagram.
+     */
+    const struct sockaddr_in &datagram_source(int index) const;
+
+    /**
+     * @brief Requests the receive timestamp of each datagram from the kernel
+     * (SO_TIMESTAMPNS). It has no effect on platforms other than Linux.
+     */
+    void enable_kernel_timestamps();
+
+    /**
+     * @brief Current time in nanoseconds since the epoch, the same clock used
+     * by datagram_timestamp().
+     */
+    static int64_t current_time_ns();
+
+    /**
+     * @brief Wakes up a thread blocked in receive_batch(). Any later call to
+     * receive_batch() returns 0 right away.
+     */
+    void unblock();
+
     int send_data(
             char* tx_buffer, 
             int tx_length, 
             const char* destAddr,
 			int destPort);        
 
+    /**
+     * @brief Resolves the destination used by send_batch(). Throws if the
+     * address is not valid.
+     */
+    void set_destination(const char* dest_addr, int dest_port);
+
+    /**
+     * @brief Sends count datagrams to the destination set with
+     * set_destination(). Datagram i starts at buffers[i] and is lengths[i]
+     * bytes long.
+     *
+     * When the send buffer is full, it waits up to SEND_WAIT_TIMEOUT_MS for
+     * room and retries. A datagram that fails, or all the remaining ones if
+     * the wait times out, are added to unsent_count() and skipped.
+     *
+     * @return the number of datagrams sent.
+     */
+    int send_batch(const char* const* buffers, const int* lengths, int count);
+
+    /**
+     * @brief Datagrams that send_batch() couldn't send so far.
+     */
+    uint64_t unsent_count() const;
+
 private:
 #ifdef _WIN32
     SOCKET sockfd;
@@ -68,7 +187,37 @@ private:
 #endif
     struct sockaddr_in server_addr, client_addr;
 
+    int batch_size_;
+    int max_datagram_size_;
+    std::vector<char> batch_buffer_;
+    std::vector<int> datagram_sizes_;
+    std::vector<int64_t> datagram_timestamps_;
+    std::vector<struct sockaddr_in> datagram_sources_;
+    std::atomic<bool> unblocked_;
+    struct sockaddr_in dest_addr_;
+#ifdef __linux__
+    int shutdown_fd_;
+    std::vector<struct mmsghdr> messages_;
+    std::vector<struct iovec> iovecs_;
+    // Ancillary data with the kernel timestamp of each message, if enabled
+    std::vector<char> control_buffers_;
+    size_t control_buffer_size_;
+    std::vector<struct mmsghdr> send_messages_;
+    std::vector<struct iovec> send_iovecs_;
+#endif
+
+    // Datagrams skipped by send_batch()
+    std::atomic<uint64_t> unsent_count_;
+
     void init_socket();
+    void set_reuse_port();
+    /**
+     * @brief Waits up to SEND_WAIT_TIMEOUT_MS until the socket can send.
+     * Returns false on timeout or error.
+     */
+    bool wait_writable();
+    // Whether the last send failed because the send buffer was full
+    static bool send_would_block();
     void bind_socket(const char* ip, int port);
 };
 
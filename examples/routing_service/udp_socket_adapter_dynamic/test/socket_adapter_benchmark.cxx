@@ -0,0 +1,365 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Per-sample cost of SocketStreamReader::take() for a ShapeType and for a
+ * larger type with a sequence of nested structures.
+ *
+ * For each type, the benchmark runs:
+ *
+ * - deserialize: the same CDR buffer is deserialized the way take() did
+ *   before the samples were pooled (into a new sample that is then copied
+ *   into another new sample) and the way it does now (into a sample reused
+ *   through the pool). It reports the time per sample of each.
+ * - take: as the ingress test of the typed adapter benchmark, a UdpSocket
+ *   sends the serialized samples over loopback to a SocketStreamReader, and a
+ *   thread plays the role of the Routing Service session, calling take() and
+ *   return_loan() when notified. It reports the time spent in those calls
+ *   per delivered sample.
+ *
+ * Each sent sample carries its sequence number in x, so the samples sent in
+ * a batch are different but have the same size.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dds/dds.hpp>
+#include <rti/topic/cdr/Serialization.hpp>
+
+#include "SocketConnection.hpp"
+#include "SocketStreamReader.hpp"
+#include "UdpSocket.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::routing;
+using namespace rti::routing::adapter;
+
+struct BenchmarkOptions {
+    std::string type = "all";
+    int port = 10299;
+    uint64_t count = 100000;
+    int batch_size = 32;
+};
+
+// Listener that does nothing, for the discovery streams
+class NullListener : public StreamReaderListener {
+public:
+    void on_data_available(StreamReader *) override
+    {
+    }
+};
+
+/**
+ * Listener that wakes up the thread calling take(), as the Routing Service
+ * session would.
+ */
+class TakeListener : public StreamReaderListener {
+public:
+    TakeListener() : data_available_(false)
+    {
+    }
+
+    void on_data_available(StreamReader *) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_available_ = true;
+        condition_.notify_one();
+    }
+
+    // Returns false if no data was available before the timeout
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool available = condition_.wait_for(lock, timeout, [this]() {
+            return data_available_;
+        });
+        data_available_ = false;
+        return available;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool data_available_;
+};
+
+static void print_usage()
+{
+    std::cout << "Usage: SocketAdapterBenchmark [options]\n"
+              << "    --type <shape|trail|all>  Types to run (default all)\n"
+              << "    --port <port>             Loopback port (default "
+                 "10299)\n"
+              << "    --count <n>               Samples per test (default "
+                 "100000)\n"
+              << "    --batch <n>               Datagrams per send and "
+                 "receive call (default 32)\n";
+}
+
+static bool parse_options(int argc, char *argv[], BenchmarkOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (option == "--type") {
+                options.type = value;
+            } else if (option == "--port") {
+                options.port = std::stoi(value);
+            } else if (option == "--count") {
+                options.count = std::stoull(value);
+            } else if (option == "--batch") {
+                options.batch_size = std::stoi(value);
+            } else {
+                return false;
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    return options.batch_size > 0 && options.count > 0;
+}
+
+static void add_shape_members(StructType &type)
+{
+    type.add_member(Member("color", StringType(128)).key(true));
+    type.add_member(Member("x", primitive_type<int32_t>()));
+    type.add_member(Member("y", primitive_type<int32_t>()));
+    type.add_member(Member("shapesize", primitive_type<int32_t>()));
+}
+
+static StructType create_shape_type()
+{
+    StructType type("ShapeType");
+    add_shape_members(type);
+    return type;
+}
+
+/**
+ * ShapeType with the last positions of the shape, a sequence of nested
+ * structures, so a sample is about 1 KB.
+ */
+static StructType create_trail_type()
+{
+    StructType point_type("TrailPoint");
+    point_type.add_member(Member("x", primitive_type<double>()));
+    point_type.add_member(Member("y", primitive_type<double>()));
+    point_type.add_member(Member("timestamp", primitive_type<int64_t>()));
+
+    StructType type("ShapeTrailType");
+    add_shape_members(type);
+    type.add_member(Member("label", StringType(256)));
+    type.add_member(Member("trail", SequenceType(point_type, 64)));
+    return type;
+}
+
+static DynamicData create_sample(const StructType &type)
+{
+    DynamicData sample(type);
+    sample.value<std::string>("color", "RED");
+    sample.value<int32_t>("y", 0);
+    sample.value<int32_t>("shapesize", 30);
+    if (type.name() == "ShapeTrailType") {
+        sample.value<std::string>("label", std::string(128, 'a'));
+        rti::core::xtypes::LoanedDynamicData trail =
+                sample.loan_value("trail");
+        // Loaning the element after the last one grows the sequence
+        for (uint32_t i = 0; i < 32; ++i) {
+            rti::core::xtypes::LoanedDynamicData point =
+                    trail.get().loan_value(i + 1);
+            point.get().value<double>("x", i);
+            point.get().value<double>("y", i);
+            point.get().value<int64_t>("timestamp", i);
+        }
+    }
+    return sample;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+}
+
+static uint64_t nanoseconds_per_sample(double seconds, uint64_t samples)
+{
+    return samples == 0 ? 0 : static_cast<uint64_t>(seconds * 1e9 / samples);
+}
+
+/**
+ * Deserializes the same buffer options.count times with each version of
+ * take().
+ */
+static void run_deserialize(
+        const BenchmarkOptions &options,
+        const StructType &type,
+        const std::vector<char> &buffer)
+{
+    // Before: a sample on the stack, copied into a new one that is loaned
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < options.count; ++i) {
+        DynamicData deserialized_sample(type);
+        rti::core::xtypes::from_cdr_buffer(deserialized_sample, buffer);
+        std::unique_ptr<DynamicData> sample(new DynamicData(type));
+        *sample = deserialized_sample;
+    }
+    double copy_seconds = seconds_since(start);
+
+    // Now: straight into a sample from the pool
+    DynamicData pooled_sample(type);
+    start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < options.count; ++i) {
+        rti::core::xtypes::from_cdr_buffer(pooled_sample, buffer);
+    }
+    double pooled_seconds = seconds_since(start);
+
+    std::cout << "    deserialize " << buffer.size() << " bytes: copy "
+              << nanoseconds_per_sample(copy_seconds, options.count)
+              << " ns/sample, pooled "
+              << nanoseconds_per_sample(pooled_seconds, options.count)
+              << " ns/sample" << std::endl;
+}
+
+/**
+ * Sends options.count samples to a SocketStreamReader and takes them from
+ * another thread, timing the take() and return_loan() calls.
+ */
+static void run_take(const BenchmarkOptions &options, StructType &type)
+{
+    NullListener discovery_listener;
+    PropertySet connection_properties;
+    SocketConnection connection(
+            &discovery_listener,
+            &discovery_listener,
+            connection_properties);
+
+    StreamInfo info("Square", type.name());
+    info.type_info().type_representation_kind(
+            TypeRepresentationKind::DYNAMIC_TYPE);
+    info.type_info().type_representation(&type.native());
+
+    PropertySet properties;
+    properties[RECEIVE_ADDRESS_STRING] = "127.0.0.1";
+    properties[RECEIVE_PORT_STRING] = std::to_string(options.port);
+    properties[RECEIVE_BATCH_SIZE_STRING] = std::to_string(options.batch_size);
+    // The ring preallocates a slot of max_datagram_size per queued packet
+    properties[RECEIVE_QUEUE_SIZE_STRING] = "16384";
+    properties[RECEIVE_SOCKET_BUFFER_SIZE_STRING] = "8388608";
+    properties[MAX_DATAGRAM_SIZE_STRING] = "2048";
+
+    TakeListener listener;
+    SocketStreamReader *reader =
+            new SocketStreamReader(&connection, info, properties, &listener);
+
+    uint64_t delivered = 0;
+    std::chrono::steady_clock::duration take_time {};
+    std::atomic<bool> sending(true);
+
+    std::thread take_thread([&]() {
+        std::vector<DynamicData *> samples;
+        std::vector<dds::sub::SampleInfo *> infos;
+        auto last_data = std::chrono::steady_clock::now();
+        while (delivered < options.count) {
+            // After the last send, stop when nothing arrives for a while
+            if (!listener.wait(std::chrono::milliseconds(100))) {
+                if (!sending && seconds_since(last_data) > 0.5) {
+                    break;
+                }
+                continue;
+            }
+            last_data = std::chrono::steady_clock::now();
+            auto start = std::chrono::steady_clock::now();
+            reader->take(samples, infos);
+            delivered += samples.size();
+            reader->return_loan(samples, infos);
+            take_time += std::chrono::steady_clock::now() - start;
+        }
+    });
+
+    // A batch of samples that differ in x, serialized once
+    DynamicData sample = create_sample(type);
+    std::vector<std::vector<char>> datagrams(options.batch_size);
+    std::vector<const char *> buffers(options.batch_size);
+    std::vector<int> lengths(options.batch_size);
+    UdpSocket sender("127.0.0.1", 0);
+    sender.set_destination("127.0.0.1", options.port);
+
+    uint64_t sent = 0;
+    while (sent < options.count) {
+        int count = static_cast<int>(std::min<uint64_t>(
+                options.batch_size,
+                options.count - sent));
+        for (int i = 0; i < count; ++i) {
+            sample.value<int32_t>("x", static_cast<int32_t>(sent + i));
+            datagrams[i].clear();
+            rti::core::xtypes::to_cdr_buffer(datagrams[i], sample);
+            buffers[i] = datagrams[i].data();
+            lengths[i] = static_cast<int>(datagrams[i].size());
+        }
+        sent += sender.send_batch(buffers.data(), lengths.data(), count);
+    }
+    sending = false;
+    take_thread.join();
+    connection.delete_stream_reader(reader);
+
+    std::cout << "    take: delivered " << delivered << " of " << sent
+              << " samples, "
+              << nanoseconds_per_sample(
+                         std::chrono::duration<double>(take_time).count(),
+                         delivered)
+              << " ns/sample in take() and return_loan()" << std::endl;
+}
+
+static void run_type(const BenchmarkOptions &options, StructType type)
+{
+    std::vector<char> buffer;
+    rti::core::xtypes::to_cdr_buffer(buffer, create_sample(type));
+
+    std::cout << type.name() << "\n";
+    run_deserialize(options, type, buffer);
+    run_take(options, type);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        if (options.type == "shape" || options.type == "all") {
+            run_type(options, create_shape_type());
+        }
+        if (options.type == "trail" || options.type == "all") {
+            run_type(options, create_trail_type());
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
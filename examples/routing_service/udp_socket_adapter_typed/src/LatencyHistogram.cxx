@@ -0,0 +1,121 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+// Values below LINEAR_LIMIT have their own bucket
+#define LINEAR_LIMIT (1ULL << LATENCY_HISTOGRAM_PRECISION_BITS)
+// Buckets in each power of two above LINEAR_LIMIT
+#define SUB_BUCKET_COUNT (LINEAR_LIMIT / 2)
+
+static int most_significant_bit(uint64_t value)
+{
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+LatencyHistogram::LatencyHistogram()
+        : counts_(bucket_index(INT64_MAX) + 1, 0), total_count_(0), max_(0)
+{
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value)
+{
+    if (value < LINEAR_LIMIT) {
+        return static_cast<size_t>(value);
+    }
+
+    /**
+     * The PRECISION_BITS most significant bits select the bucket: the shift
+     * selects the power of two and the bits below the top one select one of
+     * its SUB_BUCKET_COUNT buckets.
+     */
+    int shift = most_significant_bit(value) - LATENCY_HISTOGRAM_PRECISION_BITS
+            + 1;
+    uint64_t sub_bucket = (value >> shift) - SUB_BUCKET_COUNT;
+    return static_cast<size_t>(
+            LINEAR_LIMIT + (shift - 1) * SUB_BUCKET_COUNT + sub_bucket);
+}
+
+int64_t LatencyHistogram::bucket_highest_value(size_t index)
+{
+    if (index < LINEAR_LIMIT) {
+        return static_cast<int64_t>(index);
+    }
+    size_t shift = (index - LINEAR_LIMIT) / SUB_BUCKET_COUNT + 1;
+    uint64_t top = (index - LINEAR_LIMIT) % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    uint64_t highest = ((top + 1) << shift) - 1;
+    return highest > (uint64_t) INT64_MAX ? INT64_MAX
+                                          : static_cast<int64_t>(highest);
+}
+
+void LatencyHistogram::record(int64_t latency_ns)
+{
+    if (latency_ns < 0) {
+        latency_ns = 0;
+    }
+    ++counts_[bucket_index(static_cast<uint64_t>(latency_ns))];
+    ++total_count_;
+    max_ = std::max(max_, latency_ns);
+}
+
+int64_t LatencyHistogram::percentile(double percentile) const
+{
+    if (total_count_ == 0) {
+        return 0;
+    }
+
+    // Rank of the sample at the percentile, at least the first one
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * total_count_);
+    rank = std::max<uint64_t>(1, std::min(rank, total_count_));
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        accumulated += counts_[i];
+        if (accumulated >= rank) {
+            return std::min(bucket_highest_value(i), max_);
+        }
+    }
+    return max_;
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return total_count_;
+}
+
+int64_t LatencyHistogram::max() const
+{
+    return max_;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    max_ = 0;
+}
+
+std::string LatencyHistogram::summary() const
+{
+    std::ostringstream stream;
+    stream << "count " << total_count_ << ", p50 " << percentile(50) / 1000
+           << " us, p99 " << percentile(99) / 1000 << " us, p99.9 "
+           << percentile(99.9) / 1000 << " us, max " << max_ / 1000 << " us";
+    return stream.str();
+}
@@ -0,0 +1,72 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Log-linear histogram of latencies in nanoseconds, in the style of
+ * HdrHistogram.
+ *
+ * Values below 2^LATENCY_HISTOGRAM_PRECISION_BITS have their own bucket.
+ * Above that, every power of two is split in 2^(PRECISION_BITS - 1) buckets,
+ * so the value reported for a percentile is within ~3% of the recorded one,
+ * for the whole int64_t range, with a fixed amount of memory. Recording is a
+ * couple of bit operations and an increment.
+ *
+ * The histogram is not thread-safe, it's meant to be used from the thread
+ * calling take().
+ */
+#define LATENCY_HISTOGRAM_PRECISION_BITS 6
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * @brief Records a latency. Negative values, that can come from clock
+     * adjustments, are recorded as 0.
+     */
+    void record(int64_t latency_ns);
+
+    /**
+     * @brief Returns the highest value equivalent to the bucket that contains
+     * the given percentile (0 to 100), or 0 if nothing was recorded.
+     */
+    int64_t percentile(double percentile) const;
+
+    uint64_t count() const;
+
+    int64_t max() const;
+
+    void reset();
+
+    /**
+     * @brief Returns the count and the p50, p99, p99.9 and max latencies in
+     * microseconds, in a single line for the log.
+     */
+    std::string summary() const;
+
+private:
+    static size_t bucket_index(uint64_t value);
+    static int64_t bucket_highest_value(size_t index);
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_count_;
+    int64_t max_;
+};
+
+#endif
@@ -23,7 +23,40 @@ SocketConnection::SocketConnection(
         const PropertySet &properties)
         : input_discovery_reader_(
                 properties,
-                input_stream_discovery_listener) {};
+                input_stream_discovery_listener)
+{
+    std::string receive_address;
+    int receive_port = 0;
+    int receive_batch_size = RECEIVE_BATCH_SIZE_DEFAULT;
+    int receive_socket_buffer_size = 0;
+    bool kernel_timestamps = true;
+
+    // Parse the properties of the shared socket, all of them are optional
+    for (const auto &property : properties) {
+        if (property.first == RECEIVE_ADDRESS_STRING) {
+            receive_address = property.second;
+        } else if (property.first == RECEIVE_PORT_STRING) {
+            receive_port = std::stoi(property.second);
+        } else if (property.first == RECEIVE_BATCH_SIZE_STRING) {
+            receive_batch_size = std::stoi(property.second);
+        } else if (property.first == RECEIVE_SOCKET_BUFFER_SIZE_STRING) {
+            receive_socket_buffer_size = std::stoi(property.second);
+        } else if (property.first == KERNEL_TIMESTAMPS_STRING) {
+            kernel_timestamps =
+                    property.second == "true" || property.second == "1";
+        }
+    }
+
+    if (receive_address.size() > 0 && receive_port != 0) {
+        demultiplexer_.reset(new StreamDemultiplexer(
+                receive_address.c_str(),
+                receive_port,
+                receive_batch_size,
+                BUFFER_MAX_SIZE,
+                receive_socket_buffer_size,
+                kernel_timestamps));
+    }
+}
 
 StreamReader *SocketConnection::create_stream_reader(
         Session *session,
@@ -65,6 +98,11 @@ DiscoveryStreamReader *SocketConnection::output_stream_discovery_reader()
     return nullptr;
 }
 
+StreamDemultiplexer *SocketConnection::demultiplexer()
+{
+    return demultiplexer_.get();
+}
+
 void SocketConnection::dispose_discovery_stream(
         const rti::routing::StreamInfo &stream_info)
 {
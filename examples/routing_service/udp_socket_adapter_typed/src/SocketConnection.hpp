@@ -13,14 +13,21 @@
 #ifndef SOCKETCONNECTION_HPP
 #define SOCKETCONNECTION_HPP
 
+#include <memory>
+
 #include <rti/routing/adapter/AdapterPlugin.hpp>
 #include <rti/routing/adapter/Connection.hpp>
 
  #include "SocketInputDiscoveryStreamReader.hpp"
+ #include "StreamDemultiplexer.hpp"
 
 /*
  * This class creates the RS Connection, which is an access point to our
- * example data domain (a UDP socket)
+ * example data domain (a UDP socket).
+ *
+ * If the connection sets receive_address and receive_port, it opens a single
+ * socket shared by all the SocketStreamReaders that don't set their own, and
+ * a StreamDemultiplexer dispatches the datagrams to them by stream id.
  */
 class SocketConnection : public rti::routing::adapter::Connection {
 public:
@@ -65,8 +72,15 @@ public:
     void dispose_discovery_stream(
             const rti::routing::StreamInfo &stream_info);
 
+    /**
+     * @brief Returns the demultiplexer of the shared socket, or nullptr if
+     * the connection doesn't have a shared socket.
+     */
+    StreamDemultiplexer *demultiplexer();
+
  private:
      SocketInputDiscoveryStreamReader input_discovery_reader_;
+     std::unique_ptr<StreamDemultiplexer> demultiplexer_;
 };
 
 #endif
@@ -10,13 +10,15 @@
  * use or inability to use the software.
  */
 
+#include <sstream>
+
 #include "SocketInputDiscoveryStreamReader.hpp"
 
 using namespace rti::routing;
 using namespace rti::routing::adapter;
 
 SocketInputDiscoveryStreamReader::SocketInputDiscoveryStreamReader(
-        const PropertySet &,
+        const PropertySet &properties,
         StreamReaderListener *input_stream_discovery_listener)
 {
     input_stream_discovery_listener_ = input_stream_discovery_listener;
@@ -30,8 +32,23 @@ SocketInputDiscoveryStreamReader::SocketInputDiscoveryStreamReader(
      * that new sockets have been discovered.
      */
 
-    this->data_samples_.push_back(std::unique_ptr<rti::routing::StreamInfo>(
-            new StreamInfo("Square", "ShapeType")));
+    std::string stream_names = STREAM_NAMES_DEFAULT;
+    for (const auto &property : properties) {
+        if (property.first == STREAM_NAMES_STRING) {
+            stream_names = property.second;
+        }
+    }
+
+    std::istringstream stream_names_list(stream_names);
+    std::string stream_name;
+    while (std::getline(stream_names_list, stream_name, ',')) {
+        if (stream_name.empty()) {
+            continue;
+        }
+        this->data_samples_.push_back(
+                std::unique_ptr<rti::routing::StreamInfo>(
+                        new StreamInfo(stream_name, "ShapeType")));
+    }
 
     /**
      * Once the SocketInputDiscoveryStreamReader is initialized, we trigger an
@@ -19,10 +19,14 @@
 #include <rti/routing/adapter/AdapterPlugin.hpp>
 #include <rti/routing/adapter/DiscoveryStreamReader.hpp>
 
+#define STREAM_NAMES_STRING "stream_names"
+#define STREAM_NAMES_DEFAULT "Square"
+
 /**
  * This class implements a DiscoveryStreamReader, a special kind of StreamReader
  * that provide discovery information about the available streams and their
- * types.
+ * types. The streams are the comma-separated list in the stream_names
+ * property of the connection, all of them with type ShapeType.
  */
 
 class SocketInputDiscoveryStreamReader
@@ -29,44 +29,101 @@
     #include <unistd.h>
 #endif
 
+#include <dds/dds.hpp>
 #include "SocketStreamReader.hpp"
 #include <rti/core/Exception.hpp>
+#include <rti/routing/Logger.hpp>
 
 using namespace dds::core::xtypes;
 using namespace rti::routing;
 using namespace rti::routing::adapter;
 
-void SocketStreamReader::socket_reading_thread()
+static DDS_Time_t to_dds_time(int64_t time_ns)
+{
+    DDS_Time_t time;
+    time.sec = static_cast<DDS_Long>(time_ns / 1000000000LL);
+    time.nanosec = static_cast<DDS_UnsignedLong>(time_ns % 1000000000LL);
+    return time;
+}
+
+void SocketStreamReader::socket_reading_thread(UdpSocket *socket)
 {
     while (!stop_thread_) {
-        /**
-         * Essential to protect against concurrent data access to
-         * buffer_ from the take() methods running on a different
-         * Routing Service thread.
-         */
-        std::unique_lock<std::mutex> lock(buffer_mutex_);
-        socket->receive_data(
-                received_buffer_,
-                &received_bytes_,
-                BUFFER_MAX_SIZE);
-        lock.unlock();
-
-        // Most likely received nothing or there was an error
-        // Not doing any error handling here
-        if (received_bytes_ <= 0) {
-            // Sleep for a small period of time to avoid busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Blocks until datagrams arrive or the socket is unblocked
+        int received_count = socket->receive_batch();
+
+        if (received_count <= 0) {
             continue;
         }
 
+        {
+            /**
+             * Essential to protect against concurrent data access to
+             * packet_queue_ from the take() methods running on a different
+             * Routing Service thread.
+             */
+            std::lock_guard<std::mutex> lock(buffer_mutex_);
+            for (int i = 0; i < received_count; ++i) {
+                enqueue_packet(
+                        socket->datagram(i),
+                        socket->datagram_size(i),
+                        socket->datagram_timestamp(i));
+            }
+        }
+
         /**
          * Here we notify Routing Service, that there is data available
-         * on the StreamReader, triggering a call to take().
+         * on the StreamReader, triggering a call to take(). take() drains
+         * the whole queue, so one notification per batch is enough.
          */
         reader_listener_->on_data_available(this);
     }
+}
 
-    socket_connection_->dispose_discovery_stream(stream_info_);
+void SocketStreamReader::receive_packet(
+        const char *data,
+        int size,
+        int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    enqueue_packet(data, size, timestamp);
+}
+
+void SocketStreamReader::notify_data_available()
+{
+    reader_listener_->on_data_available(this);
+}
+
+void SocketStreamReader::enqueue_packet(
+        const char *data,
+        int size,
+        int64_t timestamp)
+{
+    // Packets too short to contain a ShapeType are discarded
+    if (size < (int) sizeof(ShapeType)) {
+        ++malformed_count_;
+        return;
+    }
+    ReceivedShape shape;
+    memcpy(&shape.shape, data, sizeof(ShapeType));
+    shape.timestamp = timestamp;
+    enqueue_shape(shape);
+}
+
+void SocketStreamReader::enqueue_shape(const ReceivedShape &shape)
+{
+    if (queue_count_ == packet_queue_.size()) {
+        if (!drop_oldest_) {
+            ++dropped_newest_count_;
+            return;
+        }
+        // Overwrite the oldest shape, the queue stays full
+        queue_head_ = (queue_head_ + 1) % packet_queue_.size();
+        --queue_count_;
+        ++dropped_oldest_count_;
+    }
+    packet_queue_[(queue_head_ + queue_count_) % packet_queue_.size()] = shape;
+    ++queue_count_;
 }
 
 SocketStreamReader::SocketStreamReader(
@@ -75,12 +132,30 @@ SocketStreamReader::SocketStreamReader(
         const PropertySet &properties,
         StreamReaderListener *listener)
         : stop_thread_(false),
+          demultiplexer_(nullptr),
+          stream_id_(stream_id_from_name(info.stream_name())),
+          receive_port_(0),
+          receive_batch_size_(RECEIVE_BATCH_SIZE_DEFAULT),
+          queue_head_(0),
+          queue_count_(0),
+          drop_oldest_(true),
+          dropped_oldest_count_(0),
+          dropped_newest_count_(0),
+          malformed_count_(0),
+          latency_statistics_period_(0),
+          last_statistics_time_(UdpSocket::current_time_ns()),
           stream_info_(info.stream_name(), info.type_info().type_name())
 {
     socket_connection_ = connection;
     reader_listener_ = listener;
     adapter_type_ =
             static_cast<DynamicType *>(info.type_info().type_representation());
+    int receive_queue_size = RECEIVE_QUEUE_SIZE_DEFAULT;
+    int receive_socket_buffer_size = 0;
+    int receive_socket_count = 1;
+    std::string multicast_group;
+    std::string multicast_interface = MULTICAST_INTERFACE_DEFAULT;
+    bool kernel_timestamps = true;
 
     // Parse the properties provided in the xml configuration file
     for (const auto &property : properties) {
@@ -90,24 +165,120 @@ SocketStreamReader::SocketStreamReader(
             receive_port_ = std::stoi(property.second);
         } else if (property.first == SHAPE_COLOR_STRING) {
             shape_color_ = property.second;
+        } else if (property.first == RECEIVE_BATCH_SIZE_STRING) {
+            receive_batch_size_ = std::stoi(property.second);
+        } else if (property.first == RECEIVE_QUEUE_SIZE_STRING) {
+            receive_queue_size = std::stoi(property.second);
+        } else if (property.first == QUEUE_OVERFLOW_POLICY_STRING) {
+            if (property.second == QUEUE_OVERFLOW_POLICY_DROP_NEWEST) {
+                drop_oldest_ = false;
+            } else if (property.second != QUEUE_OVERFLOW_POLICY_DROP_OLDEST) {
+                throw dds::core::IllegalOperationError(
+                        "queue_overflow_policy must be drop_oldest or "
+                        "drop_newest");
+            }
+        } else if (property.first == RECEIVE_SOCKET_BUFFER_SIZE_STRING) {
+            receive_socket_buffer_size = std::stoi(property.second);
+        } else if (property.first == RECEIVE_SOCKET_COUNT_STRING) {
+            receive_socket_count = std::stoi(property.second);
+        } else if (property.first == MULTICAST_GROUP_STRING) {
+            multicast_group = property.second;
+        } else if (property.first == MULTICAST_INTERFACE_STRING) {
+            multicast_interface = property.second;
+        } else if (property.first == KERNEL_TIMESTAMPS_STRING) {
+            kernel_timestamps =
+                    property.second == "true" || property.second == "1";
+        } else if (property.first == LATENCY_STATISTICS_PERIOD_STRING) {
+            latency_statistics_period_ =
+                    std::stoll(property.second) * 1000000LL;
+        } else if (property.first == STREAM_ID_STRING) {
+            stream_id_ = static_cast<uint32_t>(std::stoul(property.second));
         }
     }
 
+    /**
+     * Without its own address and port, the stream receives from the shared
+     * socket of the connection, if the connection has one
+     */
+    bool shared_socket = receive_address_.size() == 0 && receive_port_ == 0
+            && connection->demultiplexer() != nullptr;
+
     // If any of the mandatory properties is not specified, throw exception
-    if (receive_address_.size() == 0 || receive_port_ == 0
+    if ((!shared_socket
+         && (receive_address_.size() == 0 || receive_port_ == 0))
         || shape_color_.size() == 0) {
         throw dds::core::IllegalOperationError(
                 "You must set receive_address, receive_port and"
-                " shape_color in the RsSocketAdapter.xml file");
+                " shape_color in the RsSocketAdapter.xml file, or only"
+                " shape_color if the connection has a shared socket");
+    }
+
+    // The type is checked once, take() relies on these members
+    DynamicData type_check(*adapter_type_);
+    if (!type_check.member_exists_in_type("x")
+        || !type_check.member_exists_in_type("y")
+        || !type_check.member_exists_in_type("shapesize")
+        || !type_check.member_exists_in_type("color")) {
+        throw dds::core::IllegalOperationError(
+                "Stream " + info.stream_name() + " must have a ShapeType type");
+    }
+    if (receive_batch_size_ <= 0 || receive_queue_size <= 0) {
+        throw dds::core::IllegalOperationError(
+                "receive_batch_size and receive_queue_size must be greater "
+                "than 0");
+    }
+    if (receive_socket_count <= 0) {
+        throw dds::core::IllegalOperationError(
+                "receive_socket_count must be greater than 0");
     }
 
-    // Create the UDP socket to receive data
-    socket = std::unique_ptr<UdpSocket>(
-            new UdpSocket(receive_address_.c_str(), receive_port_));
+    /**
+     * Multicast datagrams are delivered to every socket of a SO_REUSEPORT
+     * group instead of being balanced between them, so each shape would be
+     * received receive_socket_count times.
+     */
+    if (!multicast_group.empty() && receive_socket_count > 1) {
+        throw dds::core::IllegalOperationError(
+                "multicast_group can only be used with receive_socket_count 1");
+    }
+    packet_queue_.resize(receive_queue_size);
+    taken_shapes_.reserve(receive_queue_size);
 
-    // Start the receive thread for UDP data
-    socketreader_thread_ =
-            std::thread(&SocketStreamReader::socket_reading_thread, this);
+    if (shared_socket) {
+        demultiplexer_ = connection->demultiplexer();
+        demultiplexer_->add_route(stream_id_, this);
+        return;
+    }
+
+    // Create the UDP sockets to receive data before starting any thread
+    for (int i = 0; i < receive_socket_count; ++i) {
+        std::unique_ptr<UdpSocket> socket(new UdpSocket(
+                receive_address_.c_str(),
+                receive_port_,
+                receive_batch_size_,
+                BUFFER_MAX_SIZE,
+                receive_socket_count > 1));
+        if (receive_socket_buffer_size > 0) {
+            socket->set_receive_buffer_size(receive_socket_buffer_size);
+        }
+        if (kernel_timestamps) {
+            socket->enable_kernel_timestamps();
+        }
+        if (!multicast_group.empty()) {
+            socket->join_multicast_group(
+                    multicast_group.c_str(),
+                    multicast_interface.c_str());
+        }
+        sockets_.push_back(std::move(socket));
+    }
+
+    // Start one receive thread per socket
+    for (auto &socket : sockets_) {
+        socketreader_threads_.push_back(std::thread(
+                &SocketStreamReader::socket_reading_thread,
+                this,
+                socket.get()));
+    }
 }
 
 /**
@@ -118,47 +289,85 @@ void SocketStreamReader::take(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
 {
-    if (stream_info_.stream_name() == "Square"
-        || stream_info_.stream_name() == "Circle"
-        || stream_info_.stream_name() == "Triangle") {
-        /**
-         * This protection is required since take() executes on a different
-         * Routing Service thread.
-         */
-        std::unique_lock<std::mutex> lock(buffer_mutex_);
-        /**
-         * The data we're sending from the socket comes in a format that makes
-         * it easy to just use reinterpret_cast. With a real type, a
-         * step-by-step mapping may be necessary
-         */
-        ShapeType *shape = reinterpret_cast<ShapeType *>(received_buffer_);
-        lock.unlock();
+    /**
+     * This protection is required since take() executes on a different
+     * Routing Service thread. We copy all the queued shapes while holding
+     * the lock, so the socket thread can't overwrite them while we
+     * build the samples.
+     */
+    taken_shapes_.clear();
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        for (size_t i = 0; i < queue_count_; ++i) {
+            taken_shapes_.push_back(
+                    packet_queue_[(queue_head_ + i) % packet_queue_.size()]);
+        }
+        queue_head_ = 0;
+        queue_count_ = 0;
+    }
 
+    samples.resize(taken_shapes_.size());
+    infos.resize(taken_shapes_.size());
+
+    int64_t now = UdpSocket::current_time_ns();
+    DDS_SampleInfo native_info = DDS_SAMPLEINFO_DEFAULT;
+    native_info.valid_data = DDS_BOOLEAN_TRUE;
+    for (size_t i = 0; i < taken_shapes_.size(); ++i) {
         /**
-         * Note that we read one packet at a time from socket_reading_thread()
+         * The data we're sending from the socket comes in a format that
+         * makes it easy to just copy it into a ShapeType. With a real
+         * type, a step-by-step mapping may be necessary
          */
-        samples.resize(1);
-        infos.resize(1);
-
+        const ShapeType &shape = taken_shapes_[i].shape;
         std::unique_ptr<DynamicData> sample(new DynamicData(*adapter_type_));
 
         /**
          * This is the hardcoded type information about ShapeType.
          * You are advised to change this as per your type definition
          */
-        sample->value("x", shape->x);
-        sample->value("y", shape->y);
-        sample->value("shapesize", shape->shapesize);
+        sample->value("x", shape.x);
+        sample->value("y", shape.y);
+        sample->value("shapesize", shape.shapesize);
         // Color is retrieved from the XML configuration
         sample->value("color", shape_color_);
 
+        // The receive time is the only timing information we have
+        int64_t timestamp = taken_shapes_[i].timestamp;
+        native_info.source_timestamp = to_dds_time(timestamp);
+        native_info.reception_timestamp = native_info.source_timestamp;
+        infos[i] = new dds::sub::SampleInfo;
+        (*infos[i])->native() = native_info;
+        if (latency_statistics_period_ > 0) {
+            latency_histogram_.record(now - timestamp);
+        }
+
         // Routing Service will send the DDS sample here
-        samples[0] = sample.release();
+        samples[i] = sample.release();
+    }
+
+    if (latency_statistics_period_ > 0) {
+        report_latency_statistics(now);
     }
 
     return;
 }
 
+void SocketStreamReader::report_latency_statistics(int64_t now)
+{
+    if (now - last_statistics_time_ < latency_statistics_period_) {
+        return;
+    }
+    last_statistics_time_ = now;
+    if (latency_histogram_.count() == 0) {
+        return;
+    }
+
+    Logger::instance().local(
+            "SocketStreamReader " + stream_info_.stream_name()
+            + ": socket to take() latency: " + latency_histogram_.summary());
+    latency_histogram_.reset();
+}
+
 void SocketStreamReader::return_loan(
         std::vector<dds::core::xtypes::DynamicData *> &samples,
         std::vector<dds::sub::SampleInfo *> &infos)
@@ -174,7 +383,26 @@ void SocketStreamReader::return_loan(
 void SocketStreamReader::shutdown_socket_reader_thread()
 {
     stop_thread_ = true;
-    socketreader_thread_.join();
+    for (auto &socket : sockets_) {
+        socket->unblock();
+    }
+    for (auto &thread : socketreader_threads_) {
+        thread.join();
+    }
+    if (demultiplexer_ != nullptr) {
+        demultiplexer_->remove_route(stream_id_);
+    }
+    socket_connection_->dispose_discovery_stream(stream_info_);
+
+    if (dropped_oldest_count_ > 0 || dropped_newest_count_ > 0
+        || malformed_count_ > 0) {
+        Logger::instance().local(
+                "SocketStreamReader " + stream_info_.stream_name()
+                + ": dropped oldest " + std::to_string(dropped_oldest_count_)
+                + ", dropped newest " + std::to_string(dropped_newest_count_)
+                + ", malformed " + std::to_string(malformed_count_)
+                + " packets");
+    }
 }
 
 SocketStreamReader::~SocketStreamReader()
@@ -13,11 +13,14 @@
 #ifndef SOCKETSTREAMREADER_HPP
 #define SOCKETSTREAMREADER_HPP
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <thread>
 
+#include "LatencyHistogram.hpp"
 #include "SocketConnection.hpp"
+#include "StreamDemultiplexer.hpp"
 #include "UdpSocket.hpp"
 
 #include <rti/routing/adapter/AdapterPlugin.hpp>
@@ -27,7 +30,34 @@
 #define RECEIVE_ADDRESS_STRING "receive_address"
 #define RECEIVE_PORT_STRING "receive_port"
 #define SHAPE_COLOR_STRING "shape_color"
-
+#define RECEIVE_BATCH_SIZE_STRING "receive_batch_size"
+#define RECEIVE_BATCH_SIZE_DEFAULT 32
+#define RECEIVE_QUEUE_SIZE_STRING "receive_queue_size"
+#define RECEIVE_QUEUE_SIZE_DEFAULT 1024
+#define QUEUE_OVERFLOW_POLICY_STRING "queue_overflow_policy"
+#define QUEUE_OVERFLOW_POLICY_DROP_OLDEST "drop_oldest"
+#define QUEUE_OVERFLOW_POLICY_DROP_NEWEST "drop_newest"
+#define RECEIVE_SOCKET_BUFFER_SIZE_STRING "receive_socket_buffer_size"
+#define RECEIVE_SOCKET_COUNT_STRING "receive_socket_count"
+#define MULTICAST_GROUP_STRING "multicast_group"
+#define MULTICAST_INTERFACE_STRING "multicast_interface"
+#define MULTICAST_INTERFACE_DEFAULT "0.0.0.0"
+#define STREAM_ID_STRING "stream_id"
+#define KERNEL_TIMESTAMPS_STRING "kernel_timestamps"
+#define LATENCY_STATISTICS_PERIOD_STRING "latency_statistics_period_ms"
+
+/**
+ * StreamReader that receives ShapeType samples from UDP. When the stream sets
+ * its own receive_address and receive_port, the reader owns its sockets and
+ * receive threads. Otherwise it receives from the shared socket of the
+ * SocketConnection, which dispatches the datagrams with this stream's
+ * stream_id to receive_packet().
+ *
+ * The SampleInfo of each sample has the time its datagram was received as
+ * source and reception timestamp. With latency_statistics_period_ms, the time
+ * between reception and take() is kept in a LatencyHistogram that is logged
+ * with that period.
+ */
 class SocketStreamReader : public rti::routing::adapter::DynamicDataStreamReader {
 public:
     SocketStreamReader(
@@ -46,39 +76,95 @@ public:
 
     void shutdown_socket_reader_thread();
 
+    /**
+     * @brief Queues a packet received by the StreamDemultiplexer of the
+     * connection. Call notify_data_available() once the batch is queued.
+     */
+    void receive_packet(const char *data, int size, int64_t timestamp);
+
+    void notify_data_available();
+
     ~SocketStreamReader();
 
 private:
     /**
-     * @brief Function used by socketreader_thread_ to read samples from the
-     * socket.
+     * @brief Function used by each of the socketreader_threads_ to read
+     * samples from its socket. With receive_socket_count greater than 1,
+     * several threads fill packet_queue_, each one from a socket bound with
+     * SO_REUSEPORT to the same address and port.
+     */
+    void socket_reading_thread(UdpSocket *socket);
+
+    struct ShapeType {
+        int x;
+        int y;
+        int shapesize;
+    };
+
+    // A shape with the time its datagram was received
+    struct ReceivedShape {
+        ShapeType shape;
+        int64_t timestamp;
+    };
+
+    /**
+     * @brief Adds a received shape to packet_queue_, applying the overflow
+     * policy when the queue is full. Must be called with buffer_mutex_ held.
      */
-    void socket_reading_thread();
+    void enqueue_shape(const ReceivedShape &shape);
+
+    /**
+     * @brief Adds the ShapeType in a received packet to packet_queue_, or
+     * counts it as malformed. Must be called with buffer_mutex_ held.
+     */
+    void enqueue_packet(const char *data, int size, int64_t timestamp);
+
+    /**
+     * @brief Logs and resets the latency histogram if the statistics period
+     * has elapsed. Called from take().
+     */
+    void report_latency_statistics(int64_t now);
 
     SocketConnection *socket_connection_;
     rti::routing::adapter::StreamReaderListener *reader_listener_;
 
-    std::unique_ptr<UdpSocket> socket;
+    std::vector<std::unique_ptr<UdpSocket>> sockets_;
 
-    std::thread socketreader_thread_;
-    bool stop_thread_;
+    std::vector<std::thread> socketreader_threads_;
+    std::atomic<bool> stop_thread_;
+    // Only set when receiving from the shared socket of the connection
+    StreamDemultiplexer *demultiplexer_;
+    uint32_t stream_id_;
 
     std::ifstream input_socket_stream_;
     std::string receive_address_;
     int receive_port_;
+    int receive_batch_size_;
     std::string shape_color_;
-    char received_buffer_[BUFFER_MAX_SIZE]; // Value that's high enough
-    int received_bytes_;
+
+    /**
+     * Bounded circular queue of the shapes received and not taken yet,
+     * protected by buffer_mutex_. When it is full, either the oldest queued
+     * shape or the new one is dropped, and the drop is counted.
+     */
+    std::vector<ReceivedShape> packet_queue_;
+    size_t queue_head_;
+    size_t queue_count_;
+    bool drop_oldest_;
+    uint64_t dropped_oldest_count_;
+    uint64_t dropped_newest_count_;
+    uint64_t malformed_count_;
     std::mutex buffer_mutex_;
+    // Shapes copied out of packet_queue_ by take(), reused between calls
+    std::vector<ReceivedShape> taken_shapes_;
+
+    // Socket to take() latency, only used from take()
+    LatencyHistogram latency_histogram_;
+    int64_t latency_statistics_period_;
+    int64_t last_statistics_time_;
 
     rti::routing::StreamInfo stream_info_;
     dds::core::xtypes::DynamicType *adapter_type_;
-
-    struct ShapeType {
-        int x;
-        int y;
-        int shapesize;
-    };
 };
 
 #endif
@@ -45,7 +45,9 @@ SocketStreamWriter::SocketStreamWriter(
         const StreamInfo &info,
         const PropertySet &properties
         )
-        : stream_info_(info.stream_name(), info.type_info().type_name())
+        : stream_info_(info.stream_name(), info.type_info().type_name()),
+          stream_header_(false),
+          stream_id_(stream_id_from_name(info.stream_name()))
 {
 
     socket_connection_ = connection;
@@ -70,37 +72,68 @@ SocketStreamWriter::SocketStreamWriter(
 		{
 			dest_port_ = std::stoi(property.second);
 		}		
+        else if (property.first == STREAM_HEADER_STRING) {
+            stream_header_ =
+                    property.second == "true" || property.second == "1";
+        } else if (property.first == STREAM_ID_STRING) {
+            stream_id_ = static_cast<uint32_t>(std::stoul(property.second));
+        }
 	}
 
 	socket = std::unique_ptr<UdpSocket>(new UdpSocket(
 		send_address_.c_str(),
 		send_port_));
+
+    // The destination is resolved once, not every time we send a sample
+    socket->set_destination(dest_address_.c_str(), dest_port_);
 }
 
 int SocketStreamWriter::write(
         const std::vector<dds::core::xtypes::DynamicData *> &samples,
         const std::vector<dds::sub::SampleInfo *> &infos)        
 {
-        size_t len = 0;
-
-		ShapeType shapes;
-		uint32_t tempObject=0;
-
-        for (const auto sample : samples) {               
-            //send sample out UDP interface
-			if (sample->member_exists_in_type("shapesize"))
-			{
-                shapes.shapesize = sample->value<int32_t>("shapesize");
-				shapes.x = sample->value<int32_t>("x");
-				shapes.y = sample->value<int32_t>("y");
-				len = +socket->send_data((char*)&shapes, sizeof(shapes), dest_address_.c_str(), dest_port_);
-			}
-			else 
-			{
-				Logger::instance().local("Received Sample that is not valid ShapeType");
-			}
-        }      
-        return len;
+    /**
+     * Convert the whole batch into shapes_, which keeps its capacity between
+     * calls, and then send all of them at once
+     */
+    shapes_.clear();
+    for (const auto sample : samples) {
+        if (sample->member_exists_in_type("shapesize")) {
+            ShapeType shape;
+            shape.shapesize = sample->value<int32_t>("shapesize");
+            shape.x = sample->value<int32_t>("x");
+            shape.y = sample->value<int32_t>("y");
+            shapes_.push_back(shape);
+        } else {
+            Logger::instance().local(
+                    "Received Sample that is not valid ShapeType");
+        }
+    }
+
+    send_buffers_.resize(shapes_.size());
+    send_lengths_.resize(shapes_.size());
+    if (stream_header_) {
+        size_t packet_size = STREAM_HEADER_SIZE + sizeof(ShapeType);
+        packets_.resize(shapes_.size() * packet_size);
+        for (size_t i = 0; i < shapes_.size(); ++i) {
+            char *packet = &packets_[i * packet_size];
+            serialize_stream_header(stream_id_, packet);
+            memcpy(packet + STREAM_HEADER_SIZE, &shapes_[i], sizeof(ShapeType));
+            send_buffers_[i] = packet;
+            send_lengths_[i] = static_cast<int>(packet_size);
+        }
+    } else {
+        for (size_t i = 0; i < shapes_.size(); ++i) {
+            send_buffers_[i] = reinterpret_cast<const char *>(&shapes_[i]);
+            send_lengths_[i] = sizeof(ShapeType);
+        }
+    }
+
+    // Send the shapes out the UDP interface, returning how many were sent
+    return socket->send_batch(
+            send_buffers_.data(),
+            send_lengths_.data(),
+            static_cast<int>(shapes_.size()));
 }
 
 int SocketStreamWriter::write(
@@ -127,4 +160,10 @@ void SocketStreamWriter::return_loan(
 
 SocketStreamWriter::~SocketStreamWriter()
 {
+    if (socket->unsent_count() > 0) {
+        Logger::instance().local(
+                "SocketStreamWriter " + stream_info_.stream_name()
+                + ": could not send " + std::to_string(socket->unsent_count())
+                + " datagrams");
+    }
 }
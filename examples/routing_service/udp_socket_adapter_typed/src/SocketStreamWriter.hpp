@@ -19,6 +19,7 @@
 #include <cstring>
 
 #include "SocketConnection.hpp"
+#include "StreamDemultiplexer.hpp"
 #include "UdpSocket.hpp"
 
 #include <rti/routing/adapter/AdapterPlugin.hpp>
@@ -29,6 +30,8 @@
 #define SEND_PORT_STRING "send_port"
 #define DEST_ADDRESS_STRING "dest_address"
 #define DEST_PORT_STRING "dest_port"
+#define STREAM_HEADER_STRING "stream_header"
+#define STREAM_ID_STRING "stream_id"
 
 class SocketStreamWriter : public rti::routing::adapter::DynamicDataStreamWriter {
 public:
@@ -79,6 +82,18 @@ private:
         int shapesize;
     };
 
+    // Batch of shapes to send and their buffers, reused between writes
+    std::vector<ShapeType> shapes_;
+    std::vector<const char *> send_buffers_;
+    std::vector<int> send_lengths_;
+
+    /**
+     * With stream_header enabled, each shape is sent after the stream id, so
+     * a connection with a shared socket can route it to the right stream
+     */
+    bool stream_header_;
+    uint32_t stream_id_;
+    std::vector<char> packets_;
 };
 
 #endif
@@ -0,0 +1,135 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "StreamDemultiplexer.hpp"
+#include "SocketStreamReader.hpp"
+
+#include <rti/core/Exception.hpp>
+#include <rti/routing/Logger.hpp>
+
+using namespace rti::routing;
+
+uint32_t stream_id_from_name(const std::string &stream_name)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : stream_name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void serialize_stream_header(uint32_t stream_id, char *buffer)
+{
+    uint32_t network_id = htonl(stream_id);
+    memcpy(buffer, &network_id, STREAM_HEADER_SIZE);
+}
+
+StreamDemultiplexer::StreamDemultiplexer(
+        const char *ip,
+        int port,
+        int batch_size,
+        int max_datagram_size,
+        int receive_socket_buffer_size,
+        bool kernel_timestamps)
+        : socket_(ip, port, batch_size, max_datagram_size),
+          stop_thread_(false),
+          unrouted_count_(0)
+{
+    if (receive_socket_buffer_size > 0) {
+        socket_.set_receive_buffer_size(receive_socket_buffer_size);
+    }
+    if (kernel_timestamps) {
+        socket_.enable_kernel_timestamps();
+    }
+    thread_ = std::thread(&StreamDemultiplexer::receive_thread, this);
+}
+
+StreamDemultiplexer::~StreamDemultiplexer()
+{
+    stop_thread_ = true;
+    socket_.unblock();
+    thread_.join();
+
+    if (unrouted_count_ > 0) {
+        Logger::instance().local(
+                "StreamDemultiplexer: dropped "
+                + std::to_string(unrouted_count_)
+                + " packets without a matching stream");
+    }
+}
+
+void StreamDemultiplexer::add_route(
+        uint32_t stream_id,
+        SocketStreamReader *reader)
+{
+    std::lock_guard<std::mutex> lock(routes_mutex_);
+    Route route = { reader, false };
+    if (!routes_.insert(std::make_pair(stream_id, route)).second) {
+        throw dds::core::IllegalOperationError(
+                "stream_id " + std::to_string(stream_id)
+                + " is already used by another stream");
+    }
+}
+
+void StreamDemultiplexer::remove_route(uint32_t stream_id)
+{
+    // Waits for the receive thread to finish dispatching the current batch
+    std::lock_guard<std::mutex> lock(routes_mutex_);
+    routes_.erase(stream_id);
+}
+
+void StreamDemultiplexer::receive_thread()
+{
+    while (!stop_thread_) {
+        // Blocks until datagrams arrive or the socket is unblocked
+        int received_count = socket_.receive_batch();
+        if (received_count <= 0) {
+            continue;
+        }
+
+        /**
+         * The routes are locked for the whole batch, so remove_route() can't
+         * return while one of the datagrams is being given to its reader.
+         */
+        std::lock_guard<std::mutex> lock(routes_mutex_);
+        for (int i = 0; i < received_count; ++i) {
+            if (socket_.datagram_size(i) < STREAM_HEADER_SIZE) {
+                ++unrouted_count_;
+                continue;
+            }
+            uint32_t network_id;
+            memcpy(&network_id, socket_.datagram(i), STREAM_HEADER_SIZE);
+            auto route = routes_.find(ntohl(network_id));
+            if (route == routes_.end()) {
+                ++unrouted_count_;
+                continue;
+            }
+
+            route->second.reader->receive_packet(
+                    socket_.datagram(i) + STREAM_HEADER_SIZE,
+                    socket_.datagram_size(i) - STREAM_HEADER_SIZE,
+                    socket_.datagram_timestamp(i));
+            if (!route->second.notify) {
+                route->second.notify = true;
+                notified_routes_.push_back(&route->second);
+            }
+        }
+
+        // take() drains the whole queue, one notification per reader is enough
+        for (Route *route : notified_routes_) {
+            route->notify = false;
+            route->reader->notify_data_available();
+        }
+        notified_routes_.clear();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef STREAMDEMULTIPLEXER_HPP
+#define STREAMDEMULTIPLEXER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "UdpSocket.hpp"
+
+// Size of the stream id that prefixes the datagrams of a shared socket
+#define STREAM_HEADER_SIZE 4
+
+class SocketStreamReader;
+
+/**
+ * @brief Returns the default stream id of a stream, the 32-bit FNV-1a hash of
+ * its name. Senders can compute it without any other configuration.
+ */
+uint32_t stream_id_from_name(const std::string &stream_name);
+
+/**
+ * @brief Writes stream_id in network byte order into the first
+ * STREAM_HEADER_SIZE bytes of buffer.
+ */
+void serialize_stream_header(uint32_t stream_id, char *buffer);
+
+/**
+ * @brief Receives the datagrams of many streams on a single UDP socket and
+ * thread, and dispatches them to the SocketStreamReader of each stream.
+ *
+ * Every datagram starts with a STREAM_HEADER_SIZE stream id in network byte
+ * order, followed by the payload of the stream. The routing table is a hash
+ * map from stream id to reader, updated only when readers are added or
+ * removed, so dispatching a datagram is a single lookup. Each reader is
+ * notified once per received batch. Datagrams for unknown streams are
+ * dropped and counted.
+ */
+class StreamDemultiplexer {
+public:
+    StreamDemultiplexer(
+            const char *ip,
+            int port,
+            int batch_size,
+            int max_datagram_size,
+            int receive_socket_buffer_size,
+            bool kernel_timestamps);
+
+    ~StreamDemultiplexer();
+
+    /**
+     * @brief Routes the datagrams with stream_id to reader. Throws if another
+     * reader already uses stream_id.
+     */
+    void add_route(uint32_t stream_id, SocketStreamReader *reader);
+
+    /**
+     * @brief Stops routing datagrams with stream_id. When it returns, the
+     * receive thread no longer uses the reader of that route.
+     */
+    void remove_route(uint32_t stream_id);
+
+private:
+    struct Route {
+        SocketStreamReader *reader;
+        bool notify;
+    };
+
+    void receive_thread();
+
+    UdpSocket socket_;
+    std::thread thread_;
+    std::atomic<bool> stop_thread_;
+
+    std::mutex routes_mutex_;
+    std::unordered_map<uint32_t, Route> routes_;
+    // Routes that received data in the current batch, reused between batches
+    std::vector<Route *> notified_routes_;
+    uint64_t unrouted_count_;
+};
+
+#endif
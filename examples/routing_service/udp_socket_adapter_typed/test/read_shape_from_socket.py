@@ -6,6 +6,9 @@ import struct
 def receive_data(sock):
     # Receive data from the socket
     data, addr = sock.recvfrom(1024)  # Buffer size of 1024 bytes
+    # Skip the stream id sent by writers with stream_header enabled
+    if len(data) == 16:
+        data = data[4:]
     # Unpack the data as 3 int types (x, y, shapesize)
     x, y, size = struct.unpack("iii", data)
     return x, y, size, addr
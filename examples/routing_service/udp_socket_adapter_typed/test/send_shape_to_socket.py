@@ -35,17 +35,26 @@ def move_position(x, y, direction_x, direction_y):
     return x, y, direction_x, direction_y
 
 
+# Default stream id of a stream, the 32-bit FNV-1a hash of its name
+def stream_id_from_name(stream_name):
+    stream_id = 2166136261
+    for byte in stream_name.encode():
+        stream_id ^= byte
+        stream_id = (stream_id * 16777619) & 0xFFFFFFFF
+    return stream_id
+
+
 # Send the data to the socket
-def send_data(sock, server_address, port, x, y):
-    # The data is "packed" as 3 int types
-    data = struct.pack("iii", x, y, shapesize)
+def send_data(sock, server_address, port, x, y, stream_header):
+    # The data is "packed" as 3 int types, after the stream id if any
+    data = stream_header + struct.pack("iii", x, y, shapesize)
     sock.sendto(data, (server_address, port))
 
 
 def main():
-    if len(sys.argv) != 3:
+    if len(sys.argv) not in (3, 4):
         print(
-            "Usage: python3 send_shape_to_socket_tester.py <server_address> <port>"
+            "Usage: python3 send_shape_to_socket_tester.py <server_address> <port> [stream_name]"
         )
         return
 
@@ -53,6 +62,12 @@ def main():
     server_address = sys.argv[1]
     port = int(sys.argv[2])
 
+    # With a stream name, the samples are sent to the shared socket of a
+    # connection, prefixed by the stream id in network byte order
+    stream_header = b""
+    if len(sys.argv) == 4:
+        stream_header = struct.pack("!I", stream_id_from_name(sys.argv[3]))
+
     x, y, direction_x, direction_y = initialize_position()
 
     samples_sent = 0
@@ -67,7 +82,7 @@ def main():
                     x, y, direction_x, direction_y
                 )
                 # Send the data to the socket
-                send_data(sock, server_address, port, x, y)
+                send_data(sock, server_address, port, x, y, stream_header)
 
                 # Simple counter to print every 100 messages
                 samples_sent += 1
@@ -0,0 +1,431 @@
+/*
+ * (c) 2025 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/**
+ * Loopback benchmark of the SocketStreamReader and SocketStreamWriter.
+ *
+ * The adapter classes are used directly, without Routing Service and without
+ * a DDS domain, so the benchmark can run on a single machine, e.g. in CI:
+ *
+ * - ingress: a UdpSocket sends datagrams of a configurable size at a
+ *   configurable rate to a SocketStreamReader. A thread plays the role of the
+ *   Routing Service session: it waits for on_data_available() and calls
+ *   take(). It reports the delivered samples/s, the loss and the latency
+ *   from send to take().
+ * - egress: batches of ShapeType samples are written with a
+ *   SocketStreamWriter and a UdpSocket counts the datagrams that arrive. It
+ *   reports the write and receive throughput and the loss.
+ *
+ * Each sent shape carries its sequence number in x, which is how the ingress
+ * test finds the send time of a taken sample and detects duplicates.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dds/dds.hpp>
+
+#include "LatencyHistogram.hpp"
+#include "SocketConnection.hpp"
+#include "SocketStreamReader.hpp"
+#include "SocketStreamWriter.hpp"
+#include "UdpSocket.hpp"
+
+using namespace dds::core::xtypes;
+using namespace rti::routing;
+using namespace rti::routing::adapter;
+
+struct BenchmarkOptions {
+    std::string test = "all";
+    int port = 10299;
+    uint64_t count = 100000;
+    uint64_t rate = 0;
+    int size = 12;
+    int batch_size = 32;
+    double max_loss = 100.0;
+};
+
+// Listener that does nothing, for the discovery streams
+class NullListener : public StreamReaderListener {
+public:
+    void on_data_available(StreamReader *) override
+    {
+    }
+};
+
+/**
+ * Listener that wakes up the thread calling take(), as the Routing Service
+ * session would.
+ */
+class TakeListener : public StreamReaderListener {
+public:
+    TakeListener() : data_available_(false)
+    {
+    }
+
+    void on_data_available(StreamReader *) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_available_ = true;
+        condition_.notify_one();
+    }
+
+    // Returns false if no data was available before the timeout
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool available = condition_.wait_for(lock, timeout, [this]() {
+            return data_available_;
+        });
+        data_available_ = false;
+        return available;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool data_available_;
+};
+
+static void print_usage()
+{
+    std::cout
+            << "Usage: SocketAdapterBenchmark [options]\n"
+            << "    --test <ingress|egress|all>  Tests to run (default all)\n"
+            << "    --port <port>                Loopback port (default "
+               "10299)\n"
+            << "    --count <n>                  Datagrams to send (default "
+               "100000)\n"
+            << "    --rate <n>                   Datagrams per second, 0 for "
+               "as fast as possible (default 0)\n"
+            << "    --size <bytes>               Ingress datagram size, 12 to "
+            << BUFFER_MAX_SIZE << " (default 12)\n"
+            << "    --batch <n>                  Datagrams per send and "
+               "receive call (default 32)\n"
+            << "    --max-loss <percent>         Fail if the loss is higher "
+               "(default 100)\n";
+}
+
+static bool parse_options(int argc, char *argv[], BenchmarkOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (option == "--test") {
+                options.test = value;
+            } else if (option == "--port") {
+                options.port = std::stoi(value);
+            } else if (option == "--count") {
+                options.count = std::stoull(value);
+            } else if (option == "--rate") {
+                options.rate = std::stoull(value);
+            } else if (option == "--size") {
+                options.size = std::stoi(value);
+            } else if (option == "--batch") {
+                options.batch_size = std::stoi(value);
+            } else if (option == "--max-loss") {
+                options.max_loss = std::stod(value);
+            } else {
+                return false;
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    return options.size >= 12 && options.size <= BUFFER_MAX_SIZE
+            && options.batch_size > 0 && options.count > 0;
+}
+
+static StructType create_shape_type()
+{
+    StructType type("ShapeType");
+    type.add_member(Member("color", StringType(128)).key(true));
+    type.add_member(Member("x", primitive_type<int32_t>()));
+    type.add_member(Member("y", primitive_type<int32_t>()));
+    type.add_member(Member("shapesize", primitive_type<int32_t>()));
+    return type;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+}
+
+/**
+ * Sleeps until sent datagrams are due at the given rate, so the send rate
+ * is kept on average even if a single sleep is longer than expected.
+ */
+static void pace(
+        uint64_t sent,
+        uint64_t rate,
+        std::chrono::steady_clock::time_point start)
+{
+    if (rate == 0) {
+        return;
+    }
+    std::this_thread::sleep_until(
+            start + std::chrono::nanoseconds(sent * 1000000000ULL / rate));
+}
+
+static double loss_percent(uint64_t sent, uint64_t received)
+{
+    return sent == 0 ? 0.0 : 100.0 * (sent - received) / sent;
+}
+
+/**
+ * Sends options.count datagrams to a SocketStreamReader and takes the
+ * samples from another thread. Returns the loss percentage.
+ */
+static double run_ingress(const BenchmarkOptions &options, StructType &type)
+{
+    NullListener discovery_listener;
+    PropertySet connection_properties;
+    SocketConnection connection(
+            &discovery_listener,
+            &discovery_listener,
+            connection_properties);
+
+    StreamInfo info("Square", "ShapeType");
+    info.type_info().type_representation_kind(
+            TypeRepresentationKind::DYNAMIC_TYPE);
+    info.type_info().type_representation(&type.native());
+
+    PropertySet properties;
+    properties[RECEIVE_ADDRESS_STRING] = "127.0.0.1";
+    properties[RECEIVE_PORT_STRING] = std::to_string(options.port);
+    properties[SHAPE_COLOR_STRING] = "RED";
+    properties[RECEIVE_BATCH_SIZE_STRING] = std::to_string(options.batch_size);
+    properties[RECEIVE_QUEUE_SIZE_STRING] = "65536";
+    properties[RECEIVE_SOCKET_BUFFER_SIZE_STRING] = "8388608";
+
+    TakeListener listener;
+    SocketStreamReader *reader =
+            new SocketStreamReader(&connection, info, properties, &listener);
+
+    // Send time of each sequence number, and whether it was already taken
+    std::vector<std::atomic<int64_t>> send_times(options.count);
+    std::vector<bool> taken(options.count, false);
+    uint64_t sent = 0;
+    uint64_t delivered = 0;
+    uint64_t duplicates = 0;
+    LatencyHistogram latency;
+    std::atomic<bool> sending(true);
+
+    std::thread take_thread([&]() {
+        std::vector<DynamicData *> samples;
+        std::vector<dds::sub::SampleInfo *> infos;
+        auto last_data = std::chrono::steady_clock::now();
+        while (delivered < options.count) {
+            // After the last send, stop when nothing arrives for a while
+            if (!listener.wait(std::chrono::milliseconds(100))) {
+                if (!sending && seconds_since(last_data) > 0.5) {
+                    break;
+                }
+                continue;
+            }
+            last_data = std::chrono::steady_clock::now();
+            reader->take(samples, infos);
+            int64_t now = UdpSocket::current_time_ns();
+            for (DynamicData *sample : samples) {
+                uint64_t sequence =
+                        static_cast<uint32_t>(sample->value<int32_t>("x"));
+                if (sequence >= options.count || taken[sequence]) {
+                    ++duplicates;
+                    continue;
+                }
+                taken[sequence] = true;
+                ++delivered;
+                latency.record(
+                        now
+                        - send_times[sequence].load(
+                                std::memory_order_relaxed));
+            }
+            reader->return_loan(samples, infos);
+        }
+    });
+
+    UdpSocket sender("127.0.0.1", 0);
+    sender.set_destination("127.0.0.1", options.port);
+    std::vector<char> datagrams(options.batch_size * options.size, 0);
+    std::vector<const char *> buffers(options.batch_size);
+    std::vector<int> lengths(options.batch_size, options.size);
+    for (int i = 0; i < options.batch_size; ++i) {
+        buffers[i] = &datagrams[i * options.size];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (sent < options.count) {
+        int count = static_cast<int>(std::min<uint64_t>(
+                options.batch_size,
+                options.count - sent));
+        int64_t now = UdpSocket::current_time_ns();
+        for (int i = 0; i < count; ++i) {
+            int32_t shape[3] = { static_cast<int32_t>(sent + i), 0, 30 };
+            memcpy(&datagrams[i * options.size], shape, sizeof(shape));
+            send_times[sent + i].store(now, std::memory_order_relaxed);
+        }
+        sent += sender.send_batch(buffers.data(), lengths.data(), count);
+        pace(sent, options.rate, start);
+    }
+    double send_seconds = seconds_since(start);
+    sending = false;
+    take_thread.join();
+    connection.delete_stream_reader(reader);
+
+    double loss = loss_percent(sent, delivered);
+    std::cout << "Ingress (SocketStreamReader)\n"
+              << "    sent " << sent << " datagrams of " << options.size
+              << " bytes in " << send_seconds << " s ("
+              << static_cast<uint64_t>(sent / send_seconds)
+              << " datagrams/s)\n"
+              << "    delivered " << delivered << " samples ("
+              << static_cast<uint64_t>(delivered / send_seconds)
+              << " samples/s), loss " << loss << "%, duplicates "
+              << duplicates << "\n"
+              << "    send to take() latency: " << latency.summary()
+              << std::endl;
+    return loss;
+}
+
+/**
+ * Writes options.count samples with a SocketStreamWriter and counts the
+ * datagrams received on loopback. Returns the loss percentage.
+ */
+static double run_egress(const BenchmarkOptions &options, StructType &type)
+{
+    NullListener discovery_listener;
+    PropertySet connection_properties;
+    SocketConnection connection(
+            &discovery_listener,
+            &discovery_listener,
+            connection_properties);
+
+    StreamInfo info("Square", "ShapeType");
+    info.type_info().type_representation_kind(
+            TypeRepresentationKind::DYNAMIC_TYPE);
+    info.type_info().type_representation(&type.native());
+
+    PropertySet properties;
+    properties[SEND_ADDRESS_STRING] = "127.0.0.1";
+    properties[SEND_PORT_STRING] = "0";
+    properties[DEST_ADDRESS_STRING] = "127.0.0.1";
+    properties[DEST_PORT_STRING] = std::to_string(options.port);
+    StreamWriter *writer = connection.create_stream_writer(
+            nullptr,
+            info,
+            properties);
+    SocketStreamWriter *socket_writer =
+            dynamic_cast<SocketStreamWriter *>(writer);
+
+    // The sink, with its own thread counting the datagrams that arrive
+    UdpSocket sink("127.0.0.1", options.port, options.batch_size);
+    sink.set_receive_buffer_size(8388608);
+    std::atomic<uint64_t> received(0);
+    std::atomic<bool> receiving(true);
+    std::thread sink_thread([&]() {
+        while (receiving) {
+            received += sink.receive_batch();
+        }
+    });
+
+    std::vector<DynamicData> batch(options.batch_size, DynamicData(type));
+    std::vector<DynamicData *> samples;
+    std::vector<dds::sub::SampleInfo *> infos;
+    uint64_t written = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (written < options.count) {
+        int count = static_cast<int>(std::min<uint64_t>(
+                options.batch_size,
+                options.count - written));
+        samples.clear();
+        for (int i = 0; i < count; ++i) {
+            batch[i].value("x", static_cast<int32_t>(written + i));
+            batch[i].value("y", 0);
+            batch[i].value("shapesize", 30);
+            samples.push_back(&batch[i]);
+        }
+        infos.assign(count, nullptr);
+        int count_written = socket_writer->write(samples, infos);
+        if (count_written <= 0) {
+            throw std::runtime_error("SocketStreamWriter failed to send");
+        }
+        written += count_written;
+        pace(written, options.rate, start);
+    }
+    double write_seconds = seconds_since(start);
+
+    // Give the sink time to read what is still in the socket buffer
+    uint64_t last_received = 0;
+    do {
+        last_received = received;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    } while (received != last_received && received < written);
+    receiving = false;
+    sink.unblock();
+    sink_thread.join();
+    connection.delete_stream_writer(writer);
+
+    double loss = loss_percent(written, received);
+    std::cout << "Egress (SocketStreamWriter)\n"
+              << "    wrote " << written << " samples in " << write_seconds
+              << " s (" << static_cast<uint64_t>(written / write_seconds)
+              << " samples/s)\n"
+              << "    received " << received << " datagrams ("
+              << static_cast<uint64_t>(received / write_seconds)
+              << " datagrams/s), loss " << loss << "%" << std::endl;
+    return loss;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    StructType type = create_shape_type();
+    double max_loss = 0.0;
+    try {
+        if (options.test == "ingress" || options.test == "all") {
+            max_loss = std::max(max_loss, run_ingress(options, type));
+        }
+        if (options.test == "egress" || options.test == "all") {
+            max_loss = std::max(max_loss, run_egress(options, type));
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (max_loss > options.max_loss) {
+        std::cerr << "Loss of " << max_loss << "% is higher than "
+                  << options.max_loss << "%" << std::endl;
+        return 1;
+    }
+    return 0;
+}